@@ -0,0 +1,456 @@
+#pragma once
+
+#include "Catalog.h"
+#include "CsvImporter.h"
+#include "LineItem.h"
+#include "MappedFile.h"
+#include "Money.h"
+#include "Order.h"
+#include "OrderAnalytics.h"
+#include "OrderLog.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <latch>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// BatchCheckout Class
+// Checks out a marketplace batch of carts, one per line:
+//
+//   Customer,Product Name,Quantity[,Product Name,Quantity...]
+//
+// in five stages, each spread over a thread pool:
+//   parse     the file is split at newlines and tokenized in place
+//   validate  product names are resolved through the catalog index (repeat
+//             lines for one product are merged); unknown names reject the cart
+//             (parse already rejected repeats adding up to over INT32_MAX)
+//   reserve   stock is taken for every line of a cart or none of it
+//   price     carts are priced at current catalog prices and become Orders
+//   log       orders are encoded in parallel and appended to the order log,
+//             a few large group commits instead of one sync per order
+//
+// Conflicts on contended products are resolved deterministically: the
+// outcome is exactly that of checking the carts out one by one in file
+// order, whatever the thread count or timing. Before reserving, each cart
+// is made to wait for the previous cart (in file order) that wants each
+// of its products; carts with no such predecessor start at once, and a
+// cart finishing releases the carts waiting on it. Carts sharing no
+// product reserve in parallel, and only carts of one hot product form a
+// chain.
+//
+// The catalog must not be changed by anything else while a batch runs.
+class BatchCheckout {
+public:
+    static constexpr std::string_view HEADER = "Customer,Product Name,Quantity";
+
+    enum class Outcome : uint8_t { Placed, UnknownProduct, OutOfStock, LogFailed };
+
+    struct StageSeconds {
+        double parse = 0.0;
+        double validate = 0.0;
+        double reserve = 0.0;
+        double price = 0.0;
+        double log = 0.0;
+
+        double total() const { return parse + validate + reserve + price + log; }
+    };
+
+    struct Result {
+        size_t carts = 0;
+        size_t placed = 0;
+        size_t unknownProduct = 0;
+        size_t outOfStock = 0;
+        size_t logFailed = 0;
+        size_t badLines = 0;
+        Money revenue;
+        StageSeconds seconds;
+        std::vector<Outcome> outcomes;  // per cart, in file order
+    };
+
+    explicit BatchCheckout(unsigned threads) : pool(threads) {}
+
+    // Checks out every cart in `filename`. Placed orders are appended to
+    // `orders` in file order, logged to `orderLog` and added to `analytics`
+    // when those are given. Returns false if the file could not be opened.
+    bool processFile(Catalog& catalog, const std::string& filename, std::vector<Order>& orders, Result& result,
+                     OrderLog* orderLog = nullptr, OrderAnalytics* analytics = nullptr) {
+        MappedFile file;
+        if (!file.open(filename)) {
+            return false;
+        }
+        process(catalog, file.view(), orders, result, orderLog, analytics);
+        return true;
+    }
+
+    void process(Catalog& catalog, std::string_view data, std::vector<Order>& orders, Result& result,
+                 OrderLog* orderLog = nullptr, OrderAnalytics* analytics = nullptr) {
+        result = Result();
+        StageClock stage;
+
+        std::vector<Chunk> chunks = parseStage(data, result);
+        std::vector<Cart*> carts;
+        for (Chunk& chunk : chunks) {
+            for (Cart& cart : chunk.carts) {
+                cart.lines = chunk.lines.data() + cart.firstLine;
+                carts.push_back(&cart);
+            }
+        }
+        result.carts = carts.size();
+        result.seconds.parse = stage.lap();
+
+        validateStage(catalog, carts);
+        result.seconds.validate = stage.lap();
+
+        reserveStage(catalog, carts);
+        result.seconds.reserve = stage.lap();
+
+        std::vector<std::vector<Order>> placed = priceStage(catalog, carts);
+        result.seconds.price = stage.lap();
+
+        logStage(catalog, carts, placed, orderLog);
+        for (std::vector<Order>& range : placed) {
+            for (Order& order : range) {
+                result.revenue += order.total();
+                if (analytics) {
+                    analytics->record(order);
+                }
+                orders.push_back(std::move(order));
+            }
+        }
+        result.seconds.log = stage.lap();
+
+        result.outcomes.reserve(carts.size());
+        for (const Cart* cart : carts) {
+            result.outcomes.push_back(cart->outcome);
+            switch (cart->outcome) {
+                case Outcome::Placed: ++result.placed; break;
+                case Outcome::UnknownProduct: ++result.unknownProduct; break;
+                case Outcome::OutOfStock: ++result.outOfStock; break;
+                case Outcome::LogFailed: ++result.logFailed; break;
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t NO_CART = UINT32_MAX;
+
+    struct StageClock {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        // Seconds since construction or the previous lap.
+        double lap() {
+            auto now = std::chrono::steady_clock::now();
+            double seconds = std::chrono::duration<double>(now - start).count();
+            start = now;
+            return seconds;
+        }
+    };
+
+    // Carts and their lines are kept flat and small, since a batch holds
+    // millions; LineItems are only built while reserving and pricing.
+    struct ParsedLine {
+        std::string_view name;  // points into the batch
+        uint32_t quantity;
+        uint32_t productId = 0;       // set by validate
+        uint32_t nextCart = NO_CART;  // the next cart wanting this product, set by reserve
+    };
+
+    struct Cart {
+        std::string_view customer;  // points into the batch
+        uint32_t firstLine = 0;      // into Chunk::lines
+        ParsedLine* lines = nullptr;  // &Chunk::lines[firstLine], once every chunk is parsed
+        uint32_t lineCount = 0;
+        Outcome outcome = Outcome::Placed;
+    };
+
+    struct Chunk {
+        std::string_view data;
+        std::vector<Cart> carts;
+        std::vector<ParsedLine> lines;
+        size_t badLines = 0;
+    };
+
+    ThreadPool pool;
+
+    // Runs task(worker) once on every pool thread and waits for all of them.
+    template <typename Task>
+    void runOnAll(Task task) {
+        std::latch done(static_cast<std::ptrdiff_t>(pool.size()));
+        for (unsigned worker = 0; worker < pool.size(); ++worker) {
+            pool.submit([&, worker] {
+                task(worker);
+                done.count_down();
+            });
+        }
+        done.wait();
+    }
+
+    // Calls body(begin, end, worker) over `count` items split into one
+    // contiguous range per pool thread, so ranges stay in order.
+    template <typename Body>
+    void forRanges(size_t count, Body body) {
+        size_t workers = pool.size();
+        runOnAll([&](unsigned worker) {
+            body(count * worker / workers, count * (worker + 1) / workers, worker);
+        });
+    }
+
+    // True if the repeat lines for some product in `lines` add up to more
+    // than INT32_MAX (the stock type's range) once validate merges them.
+    static bool repeatsOverflow(const ParsedLine* lines, uint32_t count) {
+        for (uint32_t i = 0; i < count; ++i) {
+            uint64_t sum = 0;
+            for (uint32_t j = i; j < count; ++j) {
+                sum += lines[j].name == lines[i].name ? lines[j].quantity : 0;
+            }
+            if (sum > INT32_MAX) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool parseCart(std::string_view line, Cart& cart, std::vector<ParsedLine>& lines) {
+        line = CsvImporter::trim(line);
+        size_t comma = line.find(',');
+        if (comma == std::string_view::npos || CsvImporter::trim(line.substr(0, comma)).empty()) {
+            return false;
+        }
+        cart.customer = CsvImporter::trim(line.substr(0, comma));
+        cart.firstLine = static_cast<uint32_t>(lines.size());
+        uint64_t total = 0;
+        while (comma != std::string_view::npos) {
+            line.remove_prefix(comma + 1);
+            size_t nameEnd = line.find(',');
+            if (nameEnd == std::string_view::npos) {
+                lines.resize(cart.firstLine);
+                return false;
+            }
+            ParsedLine parsed{CsvImporter::trim(line.substr(0, nameEnd)), 0};
+            line.remove_prefix(nameEnd + 1);
+            comma = line.find(',');
+            std::string_view quantity = CsvImporter::trim(line.substr(0, comma));
+            const char* end = quantity.data() + quantity.size();
+            auto parsedQuantity = std::from_chars(quantity.data(), end, parsed.quantity);
+            if (parsed.name.empty() || parsedQuantity.ec != std::errc() || parsedQuantity.ptr != end ||
+                parsed.quantity == 0 || parsed.quantity > INT32_MAX) {
+                lines.resize(cart.firstLine);
+                return false;
+            }
+            total += parsed.quantity;
+            lines.push_back(parsed);
+        }
+        cart.lineCount = static_cast<uint32_t>(lines.size()) - cart.firstLine;
+        if (total > INT32_MAX && repeatsOverflow(lines.data() + cart.firstLine, cart.lineCount)) {
+            lines.resize(cart.firstLine);
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<Chunk> parseStage(std::string_view data, Result& result) {
+        std::vector<std::string_view> pieces{data};
+        if (pool.size() > 1 && data.size() >= 2 * CsvImporter::MIN_CHUNK_BYTES) {
+            pieces = CsvImporter::splitAtNewlines(
+                data, std::min<size_t>(pool.size(), data.size() / CsvImporter::MIN_CHUNK_BYTES));
+        }
+        std::vector<Chunk> chunks(pieces.size());
+        for (size_t i = 0; i < pieces.size(); ++i) {
+            chunks[i].data = pieces[i];
+        }
+
+        std::atomic<size_t> next{0};
+        runOnAll([&](unsigned) {
+            for (size_t index; (index = next.fetch_add(1)) < chunks.size();) {
+                Chunk& chunk = chunks[index];
+                const char* pos = chunk.data.data();
+                const char* end = pos + chunk.data.size();
+                bool firstLine = index == 0;
+                while (pos < end) {
+                    const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+                    std::string_view line(pos, (newline ? newline : end) - pos);
+                    pos = newline ? newline + 1 : end;
+                    if (firstLine && CsvImporter::trim(line) == HEADER) {
+                        firstLine = false;
+                        continue;
+                    }
+                    firstLine = false;
+                    if (CsvImporter::trim(line).empty()) {
+                        continue;
+                    }
+                    Cart cart;
+                    if (parseCart(line, cart, chunk.lines)) {
+                        chunk.carts.push_back(cart);
+                    } else {
+                        ++chunk.badLines;
+                    }
+                }
+            }
+        });
+        for (const Chunk& chunk : chunks) {
+            result.badLines += chunk.badLines;
+        }
+        return chunks;
+    }
+
+    void validateStage(const Catalog& catalog, std::vector<Cart*>& carts) {
+        forRanges(carts.size(), [&](size_t begin, size_t end, unsigned) {
+            for (size_t index = begin; index < end; ++index) {
+                Cart& cart = *carts[index];
+                uint32_t kept = 0;
+                for (uint32_t i = 0; i < cart.lineCount; ++i) {
+                    ParsedLine& line = cart.lines[i];
+                    const Product* product = catalog.find(line.name, Catalog::hashName(line.name));
+                    if (!product) {
+                        cart.outcome = Outcome::UnknownProduct;
+                        break;
+                    }
+                    ParsedLine* first = cart.lines;
+                    ParsedLine* same = std::find_if(first, first + kept, [&](const ParsedLine& earlier) {
+                        return earlier.productId == product->getId();
+                    });
+                    if (same != first + kept) {
+                        same->quantity += line.quantity;  // parse rejected sums beyond INT32_MAX
+                    } else {
+                        line.productId = product->getId();
+                        first[kept++] = line;
+                    }
+                }
+                cart.lineCount = cart.outcome == Outcome::Placed ? kept : 0;
+            }
+        });
+    }
+
+    // The cart's lines as LineItems (unpriced).
+    static LineItems itemsOf(const Cart& cart) {
+        LineItems items;
+        for (uint32_t i = 0; i < cart.lineCount; ++i) {
+            items.push_back(LineItem{cart.lines[i].productId, cart.lines[i].quantity, Money()});
+        }
+        return items;
+    }
+
+    void reserveStage(Catalog& catalog, std::vector<Cart*>& carts) {
+        // Link each cart behind the previous cart wanting each of its products.
+        std::vector<uint32_t> lastCart(catalog.idLimit(), NO_CART);
+        std::vector<std::atomic<uint32_t>> waitingOn(carts.size());
+        std::vector<uint32_t> ready;
+        for (uint32_t index = 0; index < carts.size(); ++index) {
+            Cart& cart = *carts[index];
+            if (cart.outcome != Outcome::Placed) {
+                continue;
+            }
+            uint32_t predecessors = 0;
+            for (uint32_t i = 0; i < cart.lineCount; ++i) {
+                uint32_t productId = cart.lines[i].productId;
+                uint32_t last = lastCart[productId];
+                if (last != NO_CART) {
+                    const Cart& previous = *carts[last];
+                    std::find_if(previous.lines, previous.lines + previous.lineCount, [&](const ParsedLine& line) {
+                        return line.productId == productId;
+                    })->nextCart = index;
+                    ++predecessors;
+                }
+                lastCart[productId] = index;
+            }
+            waitingOn[index].store(predecessors, std::memory_order_relaxed);
+            if (predecessors == 0) {
+                ready.push_back(index);
+            }
+        }
+
+        // Workers take ready carts in turn and run the carts they release
+        // themselves, depth first.
+        std::atomic<size_t> nextReady{0};
+        runOnAll([&](unsigned) {
+            std::vector<uint32_t> released;
+            while (true) {
+                uint32_t index;
+                if (!released.empty()) {
+                    index = released.back();
+                    released.pop_back();
+                } else {
+                    size_t position = nextReady.fetch_add(1, std::memory_order_relaxed);
+                    if (position >= ready.size()) {
+                        return;
+                    }
+                    index = ready[position];
+                }
+                Cart& cart = *carts[index];
+                if (catalog.reserveStock(itemsOf(cart)) >= 0) {
+                    cart.outcome = Outcome::OutOfStock;
+                }
+                for (uint32_t i = 0; i < cart.lineCount; ++i) {
+                    uint32_t successor = cart.lines[i].nextCart;
+                    if (successor != NO_CART && waitingOn[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        released.push_back(successor);
+                    }
+                }
+            }
+        });
+    }
+
+    std::vector<std::vector<Order>> priceStage(const Catalog& catalog, std::vector<Cart*>& carts) {
+        std::vector<std::vector<Order>> placed(pool.size());
+        forRanges(carts.size(), [&](size_t begin, size_t end, unsigned worker) {
+            for (size_t i = begin; i < end; ++i) {
+                Cart& cart = *carts[i];
+                if (cart.outcome != Outcome::Placed) {
+                    continue;
+                }
+                LineItems items = itemsOf(cart);
+                for (LineItem& item : items) {
+                    item.unitPrice = catalog.findById(item.productId)->getPrice();
+                }
+                placed[worker].emplace_back(std::string(cart.customer), std::move(items));
+            }
+        });
+        return placed;
+    }
+
+    // Each range of orders is encoded on its own thread, then the ranges are
+    // appended in file order. If an append fails, the orders of that range
+    // and every later one give their stock back and are not placed.
+    void logStage(Catalog& catalog, std::vector<Cart*>& carts, std::vector<std::vector<Order>>& placed,
+                  OrderLog* orderLog) {
+        if (!orderLog) {
+            return;
+        }
+        std::vector<std::string> records(placed.size());
+        runOnAll([&](unsigned worker) {
+            for (const Order& order : placed[worker]) {
+                orderLog->encode(order, catalog, records[worker]);
+            }
+        });
+        size_t failedFrom = placed.size();
+        for (size_t range = 0; range < placed.size() && failedFrom == placed.size(); ++range) {
+            if (!records[range].empty() && !orderLog->appendBatch(records[range])) {
+                failedFrom = range;
+            }
+        }
+        if (failedFrom == placed.size()) {
+            return;
+        }
+        size_t workers = pool.size();
+        for (size_t range = failedFrom; range < placed.size(); ++range) {
+            for (const Order& order : placed[range]) {
+                catalog.releaseStock(order.getItems());
+            }
+            placed[range].clear();
+            for (size_t i = carts.size() * range / workers; i < carts.size() * (range + 1) / workers; ++i) {
+                if (carts[i]->outcome == Outcome::Placed) {
+                    carts[i]->outcome = Outcome::LogFailed;
+                }
+            }
+        }
+    }
+};
@@ -0,0 +1,349 @@
+#pragma once
+
+#include "LineItem.h"
+#include "Product.h"
+#include "StringArena.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Catalog Class
+// Products are kept contiguously in a vector (so browsing and saving are
+// plain sequential scans), and an open-addressing hash index maps each
+// product name to its slot in that vector. Lookup, insert and erase are
+// O(1) on average; erase swaps the last product into the freed slot.
+//
+// Slots move when products are erased, so each product also gets a stable
+// id on insert (ids are never reused). Orders and carts refer to products
+// by id; findById() resolves one through a direct id -> slot table.
+//
+// Product names live in a bump-pointer arena owned by the catalog (a
+// Product only holds a view), so loading millions of products makes a
+// handful of block allocations instead of one per name. Erased names are
+// reclaimed in bulk once they outweigh the live ones. Like pointers to
+// products, names returned by getName() are invalidated by erase/clear.
+//
+// reserveStock/releaseStock may run on many threads at once (stock levels
+// are atomics), alongside lookups. Everything else that modifies the
+// catalog needs exclusive access.
+class Catalog {
+    struct Bucket {
+        uint32_t hash;  // cached name hash, avoids most string compares
+        int32_t slot;   // index into products, or EMPTY
+    };
+    static constexpr int32_t EMPTY = -1;
+
+    std::vector<Product> products;
+    std::vector<Bucket> buckets;  // power-of-two sized, linear probing
+    std::vector<int32_t> idToSlot;  // EMPTY once the product is erased
+    size_t mask = 0;
+    std::atomic<uint64_t> revision{0};  // bumped on every (possible) modification
+    StringArena names;          // backs every Product::name in `products`
+    size_t deadNameBytes = 0;   // arena bytes of erased names
+
+    static constexpr size_t MIN_RECLAIM_BYTES = 1 << 20;
+
+    // Keep the load factor at or below 0.7 so probe sequences stay short.
+    static size_t bucketCountFor(size_t count) {
+        size_t n = 16;
+        while (n * 7 < count * 10) {
+            n <<= 1;
+        }
+        return n;
+    }
+
+    void rehash(size_t bucketCount) {
+        buckets.assign(bucketCount, Bucket{0, EMPTY});
+        mask = bucketCount - 1;
+        for (size_t slot = 0; slot < products.size(); ++slot) {
+            uint32_t hash = hashName(products[slot].getName());
+            size_t pos = hash & mask;
+            while (buckets[pos].slot != EMPTY) {
+                pos = (pos + 1) & mask;
+            }
+            buckets[pos] = Bucket{hash, static_cast<int32_t>(slot)};
+        }
+    }
+
+    // Returns the bucket holding `name`, or the empty bucket where it would go.
+    size_t probe(std::string_view name, uint32_t hash) const {
+        size_t pos = hash & mask;
+        while (buckets[pos].slot != EMPTY) {
+            const Bucket& bucket = buckets[pos];
+            if (bucket.hash == hash && products[bucket.slot].getName() == name) {
+                return pos;
+            }
+            pos = (pos + 1) & mask;
+        }
+        return pos;
+    }
+
+    // Finds the bucket that points at `slot` (used when a product moves).
+    size_t bucketOfSlot(size_t slot) const {
+        size_t pos = hashName(products[slot].getName()) & mask;
+        while (buckets[pos].slot != static_cast<int32_t>(slot)) {
+            pos = (pos + 1) & mask;
+        }
+        return pos;
+    }
+
+    // Backward-shift deletion: pull later members of the probe run into the
+    // hole so lookups never need tombstones.
+    void removeBucket(size_t hole) {
+        size_t pos = hole;
+        while (true) {
+            pos = (pos + 1) & mask;
+            if (buckets[pos].slot == EMPTY) {
+                break;
+            }
+            size_t home = buckets[pos].hash & mask;
+            bool homeInRange = (hole <= pos) ? (hole < home && home <= pos)
+                                             : (hole < home || home <= pos);
+            if (!homeInRange) {
+                buckets[hole] = buckets[pos];
+                hole = pos;
+            }
+        }
+        buckets[hole].slot = EMPTY;
+    }
+
+    Product* productById(uint32_t id) {
+        if (id >= idToSlot.size() || idToSlot[id] == EMPTY) {
+            return nullptr;
+        }
+        return &products[idToSlot[id]];
+    }
+
+    void releaseFirst(const LineItems& items, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (Product* product = productById(items[i].productId)) {
+                product->restoreStock(static_cast<int>(items[i].quantity));
+            }
+        }
+    }
+
+    // Copies the live names into a fresh arena once erased names take up
+    // more than half of the current one.
+    void reclaimNames() {
+        if (deadNameBytes < MIN_RECLAIM_BYTES || deadNameBytes * 2 < names.size()) {
+            return;
+        }
+        StringArena live;
+        for (Product& product : products) {
+            product.name = live.intern(product.name);
+        }
+        names = std::move(live);
+        deadNameBytes = 0;
+    }
+
+    void growFor(size_t count) {
+        if (buckets.empty() || buckets.size() * 7 < count * 10) {
+            rehash(bucketCountFor(count));
+        }
+    }
+
+public:
+    Catalog() { rehash(bucketCountFor(0)); }
+
+    // Exposed so bulk loaders can hash names on worker threads.
+    static uint32_t hashName(std::string_view name) {
+        return static_cast<uint32_t>(std::hash<std::string_view>{}(name));
+    }
+
+    size_t size() const { return products.size(); }
+    // Changes whenever the catalog may have been modified, including through
+    // the non-const find(); derived views compare it to know when to rebuild.
+    uint64_t version() const { return revision.load(std::memory_order_relaxed); }
+    bool empty() const { return products.empty(); }
+
+    std::vector<Product>::const_iterator begin() const { return products.begin(); }
+    std::vector<Product>::const_iterator end() const { return products.end(); }
+    const std::vector<Product>& items() const { return products; }
+
+    void reserve(size_t count) {
+        products.reserve(count);
+        growFor(count);
+    }
+
+    void clear() {
+        revision.fetch_add(1, std::memory_order_relaxed);
+        idToSlot.assign(idToSlot.size(), EMPTY);
+        products.clear();
+        names.clear();
+        deadNameBytes = 0;
+        rehash(bucketCountFor(0));
+    }
+
+    const Product* find(std::string_view name) const {
+        size_t pos = probe(name, hashName(name));
+        return buckets[pos].slot == EMPTY ? nullptr : &products[buckets[pos].slot];
+    }
+
+    Product* find(std::string_view name) {
+        revision.fetch_add(1, std::memory_order_relaxed);
+        size_t pos = probe(name, hashName(name));
+        return buckets[pos].slot == EMPTY ? nullptr : &products[buckets[pos].slot];
+    }
+
+    // Same as the const find() with a precomputed hashName(name), so
+    // bulk loaders can look names up on worker threads.
+    const Product* find(std::string_view name, uint32_t hash) const {
+        size_t pos = probe(name, hash);
+        return buckets[pos].slot == EMPTY ? nullptr : &products[buckets[pos].slot];
+    }
+
+    bool contains(std::string_view name) const { return find(name) != nullptr; }
+
+    // One past the highest id handed out so far; ids below it that no longer
+    // resolve belong to erased products.
+    uint32_t idLimit() const { return static_cast<uint32_t>(idToSlot.size()); }
+
+    const Product* findById(uint32_t id) const {
+        if (id >= idToSlot.size() || idToSlot[id] == EMPTY) {
+            return nullptr;
+        }
+        return &products[idToSlot[id]];
+    }
+
+    // Takes the stock for every line item, or for none of them: lines are
+    // reserved in order with a lock-free decrement each, and if one cannot
+    // be satisfied the earlier ones are given back. Returns the index of
+    // the failing line (product gone or not enough stock), or -1 on success.
+    long reserveStock(const LineItems& items) {
+        for (size_t i = 0; i < items.size(); ++i) {
+            Product* product = productById(items[i].productId);
+            if (!product || items[i].quantity > INT32_MAX ||
+                !product->reduceStock(static_cast<int>(items[i].quantity))) {
+                releaseFirst(items, i);
+                return static_cast<long>(i);
+            }
+        }
+        revision.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+
+    // Returns the stock taken by a successful reserveStock(items).
+    void releaseStock(const LineItems& items) {
+        releaseFirst(items, items.size());
+        revision.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Adds a product; returns false (and leaves the catalog unchanged) if a
+    // product with the same name already exists.
+    bool insert(Product product) {
+        growFor(products.size() + 1);
+        uint32_t hash = hashName(product.getName());
+        size_t pos = probe(product.getName(), hash);
+        if (buckets[pos].slot != EMPTY) {
+            return false;
+        }
+        revision.fetch_add(1, std::memory_order_relaxed);
+        buckets[pos] = Bucket{hash, static_cast<int32_t>(products.size())};
+        product.name = names.intern(product.name);
+        product.id = static_cast<uint32_t>(idToSlot.size());
+        idToSlot.push_back(static_cast<int32_t>(products.size()));
+        products.push_back(std::move(product));
+        return true;
+    }
+
+    // Adds a product or overwrites the price and stock of an existing one.
+    // Returns true if a new product was inserted.
+    bool insertOrAssign(Product product) {
+        uint32_t hash = hashName(product.getName());
+        return insertOrAssign(std::move(product), hash);
+    }
+
+    // Same as above with a precomputed hashName(product.getName()).
+    bool insertOrAssign(Product product, uint32_t hash) {
+        growFor(products.size() + 1);
+        size_t pos = probe(product.getName(), hash);
+        if (buckets[pos].slot != EMPTY) {
+            revision.fetch_add(1, std::memory_order_relaxed);
+            Product& existing = products[buckets[pos].slot];
+            existing.setPrice(product.getPrice());
+            existing.setStock(product.getStock());
+            return false;
+        }
+        revision.fetch_add(1, std::memory_order_relaxed);
+        buckets[pos] = Bucket{hash, static_cast<int32_t>(products.size())};
+        product.name = names.intern(product.name);
+        product.id = static_cast<uint32_t>(idToSlot.size());
+        idToSlot.push_back(static_cast<int32_t>(products.size()));
+        products.push_back(std::move(product));
+        return true;
+    }
+
+    enum class Upsert { Inserted, Updated, Unchanged };
+
+    // Sets the price and stock of product `name`, inserting it if it is new.
+    // Unlike insertOrAssign, a product that already has this price and
+    // stock is not written and the revision is not bumped, so replaying an
+    // unchanged row leaves derived views valid. `hash` is hashName(name);
+    // `id` receives the product's id.
+    Upsert upsert(std::string_view name, Money price, int stock, uint32_t hash, uint32_t& id) {
+        growFor(products.size() + 1);
+        size_t pos = probe(name, hash);
+        if (buckets[pos].slot != EMPTY) {
+            Product& existing = products[buckets[pos].slot];
+            id = existing.id;
+            if (existing.getPrice() == price && existing.getStock() == stock) {
+                return Upsert::Unchanged;
+            }
+            revision.fetch_add(1, std::memory_order_relaxed);
+            existing.setPrice(price);
+            existing.setStock(stock);
+            return Upsert::Updated;
+        }
+        revision.fetch_add(1, std::memory_order_relaxed);
+        buckets[pos] = Bucket{hash, static_cast<int32_t>(products.size())};
+        id = static_cast<uint32_t>(idToSlot.size());
+        idToSlot.push_back(static_cast<int32_t>(products.size()));
+        products.emplace_back(names.intern(name), price, stock);
+        products.back().id = id;
+        return Upsert::Inserted;
+    }
+
+    // Sets the price of product `id` and moves its stock by `stockDelta`
+    // (see Product::shiftStock) rather than overwriting it, so units
+    // reserved since the caller read the stock stay reserved. Like upsert,
+    // a no-op change is not written.
+    Upsert adjust(uint32_t id, Money price, int64_t stockDelta) {
+        Product* product = productById(id);
+        if (!product || (product->getPrice() == price && stockDelta == 0)) {
+            return Upsert::Unchanged;
+        }
+        revision.fetch_add(1, std::memory_order_relaxed);
+        product->setPrice(price);
+        if (stockDelta != 0) {
+            Product::shiftStock(product->stock, stockDelta);
+        }
+        return Upsert::Updated;
+    }
+
+    bool erase(std::string_view name) {
+        size_t pos = probe(name, hashName(name));
+        if (buckets[pos].slot == EMPTY) {
+            return false;
+        }
+        revision.fetch_add(1, std::memory_order_relaxed);
+        size_t slot = buckets[pos].slot;
+        removeBucket(pos);
+
+        idToSlot[products[slot].id] = EMPTY;
+        deadNameBytes += products[slot].name.size();
+        size_t last = products.size() - 1;
+        if (slot != last) {
+            buckets[bucketOfSlot(last)].slot = static_cast<int32_t>(slot);
+            idToSlot[products[last].id] = static_cast<int32_t>(slot);
+            products[slot] = std::move(products[last]);
+        }
+        products.pop_back();
+        reclaimNames();
+        return true;
+    }
+};
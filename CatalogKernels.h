@@ -0,0 +1,194 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define ECOMMERCE_HAVE_AVX2_KERNELS 1
+#endif
+
+// CatalogKernels Class
+// Scan kernels over ColumnarCatalog's price (integer cents) and stock
+// columns, in a portable scalar version and an AVX2 version. best() picks the AVX2 table once at
+// runtime when the CPU supports it, so the binary still runs on older
+// machines. Filter kernels write matching row numbers to `out`, which must
+// have room for `count` entries, and return how many they wrote.
+//
+// Prices are integer cents, so the AVX2 inventoryValue gives exactly the
+// scalar result even though it adds in a different order.
+class CatalogKernels {
+public:
+    using FilterRangeFn = size_t (*)(const int64_t* prices, const int* stocks, size_t count,
+                                     int64_t minPrice, int64_t maxPrice, int minStock, uint32_t* out);
+    using InventoryValueFn = int64_t (*)(const int64_t* prices, const int* stocks, size_t count);
+    using LowStockFn = size_t (*)(const int* stocks, size_t count, int threshold, uint32_t* out);
+
+    struct Table {
+        const char* name;
+        FilterRangeFn filterRange;
+        InventoryValueFn inventoryValue;
+        LowStockFn lowStock;
+    };
+
+    static const Table& scalar() {
+        static const Table table{"scalar", scalarFilterRange, scalarInventoryValue, scalarLowStock};
+        return table;
+    }
+
+    // Returns nullptr when AVX2 kernels are not available on this build/CPU.
+    static const Table* avx2() {
+#ifdef ECOMMERCE_HAVE_AVX2_KERNELS
+        static const Table table{"avx2", avx2FilterRange, avx2InventoryValue, avx2LowStock};
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported ? &table : nullptr;
+#else
+        return nullptr;
+#endif
+    }
+
+    static const Table& best() {
+        static const Table& chosen = avx2() ? *avx2() : scalar();
+        return chosen;
+    }
+
+private:
+    static size_t scalarFilterRange(const int64_t* prices, const int* stocks, size_t count,
+                                    int64_t minPrice, int64_t maxPrice, int minStock, uint32_t* out) {
+        size_t matches = 0;
+        for (size_t i = 0; i < count; ++i) {
+            out[matches] = static_cast<uint32_t>(i);
+            matches += (prices[i] >= minPrice) & (prices[i] <= maxPrice) & (stocks[i] >= minStock);
+        }
+        return matches;
+    }
+
+    static int64_t scalarInventoryValue(const int64_t* prices, const int* stocks, size_t count) {
+        int64_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            total += prices[i] * stocks[i];
+        }
+        return total;
+    }
+
+    static size_t scalarLowStock(const int* stocks, size_t count, int threshold, uint32_t* out) {
+        size_t matches = 0;
+        for (size_t i = 0; i < count; ++i) {
+            out[matches] = static_cast<uint32_t>(i);
+            matches += stocks[i] < threshold;
+        }
+        return matches;
+    }
+
+#ifdef ECOMMERCE_HAVE_AVX2_KERNELS
+    // For every 8-bit lane mask, the positions of its set bits packed into
+    // bytes (lowest first). Used to left-pack matching row numbers.
+    static constexpr std::array<uint64_t, 256> makeCompressTable() {
+        std::array<uint64_t, 256> table{};
+        for (unsigned mask = 0; mask < 256; ++mask) {
+            uint64_t packed = 0;
+            unsigned slot = 0;
+            for (unsigned bit = 0; bit < 8; ++bit) {
+                if (mask & (1u << bit)) {
+                    packed |= static_cast<uint64_t>(bit) << (8 * slot++);
+                }
+            }
+            table[mask] = packed;
+        }
+        return table;
+    }
+
+    // Writes base + position for every set bit of `mask` to out and returns
+    // the number written. Always stores 8 lanes, so out needs 8 free slots.
+    __attribute__((target("avx2")))
+    static size_t storeMatches(unsigned mask, uint32_t base, uint32_t* out) {
+        static constexpr std::array<uint64_t, 256> compressTable = makeCompressTable();
+        __m128i packed = _mm_cvtsi64_si128(static_cast<long long>(compressTable[mask]));
+        __m256i rows = _mm256_add_epi32(_mm256_cvtepu8_epi32(packed),
+                                        _mm256_set1_epi32(static_cast<int>(base)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), rows);
+        return static_cast<size_t>(__builtin_popcount(mask));
+    }
+
+    __attribute__((target("avx2")))
+    static size_t avx2FilterRange(const int64_t* prices, const int* stocks, size_t count,
+                                  int64_t minPrice, int64_t maxPrice, int minStock, uint32_t* out) {
+        const __m256i lo = _mm256_set1_epi64x(minPrice);
+        const __m256i hi = _mm256_set1_epi64x(maxPrice);
+        const __m256i stockFloor = _mm256_set1_epi32(minStock);
+        size_t matches = 0;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prices + i));
+            __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prices + i + 4));
+            __m256i out0 = _mm256_or_si256(_mm256_cmpgt_epi64(lo, p0), _mm256_cmpgt_epi64(p0, hi));
+            __m256i out1 = _mm256_or_si256(_mm256_cmpgt_epi64(lo, p1), _mm256_cmpgt_epi64(p1, hi));
+            unsigned priceMask = ~(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(out0)))
+                                   | static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(out1))) << 4);
+
+            __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stocks + i));
+            unsigned belowFloor = static_cast<unsigned>(
+                _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(stockFloor, s))));
+
+            matches += storeMatches(priceMask & ~belowFloor & 0xFFu, static_cast<uint32_t>(i), out + matches);
+        }
+        size_t tail = scalarFilterRange(prices + i, stocks + i, count - i, minPrice, maxPrice,
+                                        minStock, out + matches);
+        return matches + rebaseTail(out + matches, tail, i);
+    }
+
+    // AVX2 has no 64x64-bit multiply, so this uses the signed 32x32->64
+    // one, which is exact while every price fits in 32 bits (up to
+    // $21,474,836.47). Larger prices are flagged and the whole column is
+    // summed by the scalar loop instead.
+    __attribute__((target("avx2")))
+    static int64_t avx2InventoryValue(const int64_t* prices, const int* stocks, size_t count) {
+        const __m256i bias = _mm256_set1_epi64x(int64_t(1) << 31);
+        __m256i acc0 = _mm256_setzero_si256();
+        __m256i acc1 = _mm256_setzero_si256();
+        __m256i wide = _mm256_setzero_si256();  // nonzero once a price needs more than 32 bits
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prices + i));
+            __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prices + i + 4));
+            __m256i s0 = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(stocks + i)));
+            __m256i s1 = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(stocks + i + 4)));
+            wide = _mm256_or_si256(wide, _mm256_srli_epi64(_mm256_add_epi64(p0, bias), 32));
+            wide = _mm256_or_si256(wide, _mm256_srli_epi64(_mm256_add_epi64(p1, bias), 32));
+            acc0 = _mm256_add_epi64(acc0, _mm256_mul_epi32(p0, s0));
+            acc1 = _mm256_add_epi64(acc1, _mm256_mul_epi32(p1, s1));
+        }
+        if (!_mm256_testz_si256(wide, wide)) {
+            return scalarInventoryValue(prices, stocks, count);
+        }
+        alignas(32) int64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(acc0, acc1));
+        int64_t total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        return total + scalarInventoryValue(prices + i, stocks + i, count - i);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t avx2LowStock(const int* stocks, size_t count, int threshold, uint32_t* out) {
+        const __m256i limit = _mm256_set1_epi32(threshold);
+        size_t matches = 0;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stocks + i));
+            unsigned below = static_cast<unsigned>(
+                _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(limit, s))));
+            matches += storeMatches(below, static_cast<uint32_t>(i), out + matches);
+        }
+        size_t tail = scalarLowStock(stocks + i, count - i, threshold, out + matches);
+        return matches + rebaseTail(out + matches, tail, i);
+    }
+
+    // The scalar tail loops number rows from 0; shift them to absolute rows.
+    static size_t rebaseTail(uint32_t* rows, size_t count, size_t base) {
+        for (size_t k = 0; k < count; ++k) {
+            rows[k] += static_cast<uint32_t>(base);
+        }
+        return count;
+    }
+#endif
+};
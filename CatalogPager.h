@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Catalog.h"
+#include "Money.h"
+#include "ShardedCatalog.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// CatalogPager Class
+// Renders the catalog one page at a time for browsing. Each page (header
+// line plus one line per product, in the displayProduct format) is
+// formatted with std::to_chars into a buffer the pager keeps between
+// pages. The caller can then emit the whole page with a single write and
+// one flush, instead of one formatted stream write and flush per product.
+//
+// Pages are addressed by offset and limit; next() continues from a cursor
+// left by the previous page. Offsets index the catalog's iteration order,
+// so products added or removed between pages can shift what the next page
+// starts with.
+class CatalogPager {
+public:
+    static constexpr size_t DEFAULT_PAGE_SIZE = 20;
+
+    struct Page {
+        std::string_view text;  // valid until the next render
+        size_t first = 0;       // offset of the first product shown
+        size_t count = 0;       // products on this page
+        size_t total = 0;       // products in the catalog
+
+        bool hasMore() const { return first + count < total; }
+    };
+
+private:
+    static constexpr size_t INITIAL_BUFFER_BYTES = 16 * 1024;
+    // Fixed text plus the longest price and stock; the name is added on top.
+    static constexpr size_t MAX_LINE_OVERHEAD = 64;
+
+    std::vector<char> buffer;  // allocated on first render, grown only if a page outgrows it
+    size_t used = 0;
+    size_t cursor = 0;
+
+    void ensure(size_t bytes) {
+        if (buffer.size() - used < bytes) {
+            buffer.resize(std::max(buffer.size() * 2, used + bytes));
+        }
+    }
+
+    void put(std::string_view text) {
+        std::memcpy(buffer.data() + used, text.data(), text.size());
+        used += text.size();
+    }
+
+    template <typename Number>
+    void putNumber(Number value) {
+        used = static_cast<size_t>(std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), value).ptr -
+                                   buffer.data());
+    }
+
+    void putNumber(Money amount) {
+        used = static_cast<size_t>(amount.format(buffer.data() + used, buffer.data() + buffer.size()) - buffer.data());
+    }
+
+    template <typename Item>
+    void putProduct(const Item& product) {
+        ensure(product.getName().size() + MAX_LINE_OVERHEAD);
+        put("Product: ");
+        put(product.getName());
+        put(", Price: $");
+        putNumber(product.getPrice());
+        put(", Stock: ");
+        putNumber(product.getStock());
+        put("\n");
+    }
+
+    static std::vector<Product>::const_iterator seek(const Catalog& catalog, size_t offset) {
+        return catalog.begin() + static_cast<std::ptrdiff_t>(offset);
+    }
+
+    static ShardedCatalog::Reader::const_iterator seek(const ShardedCatalog::Reader& catalog, size_t offset) {
+        return catalog.at(offset);
+    }
+
+public:
+    // Renders up to `limit` products starting at `offset` and leaves the
+    // cursor after them (back at the start once the catalog is exhausted).
+    // Takes a Catalog or a ShardedCatalog::Reader.
+    template <typename CatalogView>
+    Page render(const CatalogView& catalog, size_t offset, size_t limit = DEFAULT_PAGE_SIZE) {
+        if (buffer.empty()) {
+            buffer.resize(INITIAL_BUFFER_BYTES);
+        }
+        used = 0;
+
+        Page page;
+        page.total = catalog.size();
+        page.first = std::min(offset, page.total);
+        page.count = std::min(limit, page.total - page.first);
+
+        ensure(MAX_LINE_OVERHEAD);
+        if (page.count == 0) {
+            put(page.total == 0 ? "The catalog is empty.\n" : "No more products.\n");
+        } else {
+            put("Product Catalog (");
+            putNumber(page.first + 1);
+            put("-");
+            putNumber(page.first + page.count);
+            put(" of ");
+            putNumber(page.total);
+            put("):\n");
+            auto it = seek(catalog, page.first);
+            for (size_t i = 0; i < page.count; ++i, ++it) {
+                putProduct(*it);
+            }
+        }
+
+        cursor = page.hasMore() ? page.first + page.count : 0;
+        page.text = std::string_view(buffer.data(), used);
+        return page;
+    }
+
+    // The page after the last one rendered.
+    template <typename CatalogView>
+    Page next(const CatalogView& catalog, size_t limit = DEFAULT_PAGE_SIZE) {
+        return render(catalog, cursor, limit);
+    }
+
+    size_t position() const { return cursor; }
+};
@@ -0,0 +1,273 @@
+#pragma once
+
+#include "Catalog.h"
+#include "FileUtil.h"
+#include "MappedFile.h"
+#include "Money.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+
+// CatalogSnapshot Class
+// Versioned binary image of the catalog that is used straight from an mmap
+// with no per-row parsing. Layout (native byte order, 8-byte aligned
+// sections):
+//
+//   Header       magic, format version, byte-order mark, counts, offsets
+//   prices       int64[productCount], in cents
+//   stocks       int32[productCount]
+//   nameOffsets  uint64[productCount + 1], offsets into the string table
+//   buckets      {uint32 hashTag, uint32 row + 1}[bucketCount], a
+//                linear-probing name index (row + 1 == 0 means empty)
+//   names        string table, names back to back without separators
+//
+// open() only validates the header, and find()/nameAt()/stockAt() read the
+// stored index and columns in place, so those never parse the file. The
+// application itself does not serve from the mapping: "Load Product Catalog
+// Snapshot" goes through loadInto(), an O(n) copy into the mutable Catalog
+// (no text parsing, but still a pass over every row), and startup still
+// reads products.csv because CsvSync needs the feed's own stock values as
+// its baselines, which a snapshot of live stock cannot supply.
+class CatalogSnapshot {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 2;  // 2: prices in integer cents
+
+private:
+    static constexpr char MAGIC[8] = {'E', 'C', 'S', 'N', 'A', 'P', '\0', '\0'};
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    struct Header {
+        char magic[8];
+        uint32_t formatVersion;
+        uint32_t byteOrderMark;
+        uint64_t productCount;
+        uint64_t bucketCount;
+        uint64_t pricesOffset;
+        uint64_t stocksOffset;
+        uint64_t nameOffsetsOffset;
+        uint64_t bucketsOffset;
+        uint64_t namesOffset;
+        uint64_t namesSize;
+        uint64_t fileSize;
+    };
+
+    struct Bucket {
+        uint32_t hashTag;
+        uint32_t rowPlusOne;
+    };
+
+    MappedFile file;
+    const Header* header = nullptr;
+    const int64_t* prices = nullptr;
+    const int32_t* stocks = nullptr;
+    const uint64_t* nameOffsets = nullptr;
+    const Bucket* buckets = nullptr;
+    const char* names = nullptr;
+
+    // FNV-1a, fixed here so the stored index does not depend on the
+    // standard library's std::hash.
+    static uint64_t hashName(std::string_view name) {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : name) {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static uint64_t alignUp(uint64_t offset) { return (offset + 7) & ~uint64_t(7); }
+
+    bool sectionFits(uint64_t offset, uint64_t bytes) const {
+        return offset % 8 == 0 && offset <= file.size() && bytes <= file.size() - offset;
+    }
+
+public:
+    // Maps and validates `filename`. Returns false for a missing, truncated
+    // or incompatible file.
+    bool open(const std::string& filename) {
+        header = nullptr;
+        if (!file.open(filename, false) || file.size() < sizeof(Header)) {
+            return false;
+        }
+        const char* base = file.view().data();
+        const Header* candidate = reinterpret_cast<const Header*>(base);
+        uint64_t count = candidate->productCount;
+        uint64_t bucketCount = candidate->bucketCount;
+        if (std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            candidate->formatVersion != FORMAT_VERSION ||
+            candidate->byteOrderMark != BYTE_ORDER_MARK ||
+            candidate->fileSize != file.size() ||
+            count >= UINT32_MAX || bucketCount <= count || bucketCount > file.size() ||
+            (bucketCount & (bucketCount - 1)) != 0) {
+            return false;
+        }
+        header = candidate;
+        if (!sectionFits(header->pricesOffset, count * sizeof(int64_t)) ||
+            !sectionFits(header->stocksOffset, count * sizeof(int32_t)) ||
+            !sectionFits(header->nameOffsetsOffset, (count + 1) * sizeof(uint64_t)) ||
+            !sectionFits(header->bucketsOffset, bucketCount * sizeof(Bucket)) ||
+            header->namesOffset > file.size() || header->namesSize > file.size() - header->namesOffset) {
+            header = nullptr;
+            return false;
+        }
+        prices = reinterpret_cast<const int64_t*>(base + header->pricesOffset);
+        stocks = reinterpret_cast<const int32_t*>(base + header->stocksOffset);
+        nameOffsets = reinterpret_cast<const uint64_t*>(base + header->nameOffsetsOffset);
+        buckets = reinterpret_cast<const Bucket*>(base + header->bucketsOffset);
+        names = base + header->namesOffset;
+        return true;
+    }
+
+    bool isOpen() const { return header != nullptr; }
+    size_t size() const { return header ? header->productCount : 0; }
+
+    // Offsets are checked on access rather than at open() so opening stays
+    // O(1); a corrupt entry reads as an empty name.
+    std::string_view nameAt(size_t row) const {
+        uint64_t begin = nameOffsets[row];
+        uint64_t end = nameOffsets[row + 1];
+        if (begin > end || end > header->namesSize) {
+            return std::string_view();
+        }
+        return std::string_view(names + begin, end - begin);
+    }
+    Money priceAt(size_t row) const { return Money::fromCents(prices[row]); }
+    int stockAt(size_t row) const { return stocks[row]; }
+    const int64_t* priceData() const { return prices; }  // cents
+    const int32_t* stockData() const { return stocks; }
+
+    // Row holding `name`, or -1 if it is not in the snapshot.
+    int64_t find(std::string_view name) const {
+        if (!header) {
+            return -1;
+        }
+        uint64_t hash = hashName(name);
+        uint32_t tag = static_cast<uint32_t>(hash >> 32);
+        uint64_t mask = header->bucketCount - 1;
+        for (uint64_t probes = 0, pos = hash & mask; probes < header->bucketCount;
+             ++probes, pos = (pos + 1) & mask) {
+            const Bucket& bucket = buckets[pos];
+            if (bucket.rowPlusOne == 0 || bucket.rowPlusOne > header->productCount) {
+                return -1;
+            }
+            if (bucket.hashTag == tag && nameAt(bucket.rowPlusOne - 1) == name) {
+                return bucket.rowPlusOne - 1;
+            }
+        }
+        return -1;
+    }
+
+    // Copies every product into `catalog` (overwriting same-named ones).
+    void loadInto(Catalog& catalog) const {
+        size_t count = size();
+        catalog.reserve(catalog.size() + count);
+        for (size_t row = 0; row < count; ++row) {
+            catalog.insertOrAssign(Product(nameAt(row), Money::fromCents(prices[row]), stocks[row]));
+        }
+    }
+
+    // Writes `catalog` as a snapshot, atomically replacing `filename`.
+    static bool write(const Catalog& catalog, const std::string& filename) {
+        uint64_t count = catalog.size();
+        if (count >= UINT32_MAX) {
+            return false;
+        }
+        uint64_t bucketCount = 16;
+        while (bucketCount < count * 2) {
+            bucketCount <<= 1;
+        }
+        uint64_t namesSize = 0;
+        for (const Product& product : catalog) {
+            namesSize += product.getName().size();
+        }
+
+        Header out{};
+        std::memcpy(out.magic, MAGIC, sizeof(MAGIC));
+        out.formatVersion = FORMAT_VERSION;
+        out.byteOrderMark = BYTE_ORDER_MARK;
+        out.productCount = count;
+        out.bucketCount = bucketCount;
+        out.pricesOffset = alignUp(sizeof(Header));
+        out.stocksOffset = alignUp(out.pricesOffset + count * sizeof(int64_t));
+        out.nameOffsetsOffset = alignUp(out.stocksOffset + count * sizeof(int32_t));
+        out.bucketsOffset = alignUp(out.nameOffsetsOffset + (count + 1) * sizeof(uint64_t));
+        out.namesOffset = out.bucketsOffset + bucketCount * sizeof(Bucket);
+        out.namesSize = namesSize;
+        out.fileSize = out.namesOffset + namesSize;
+
+        std::vector<Bucket> index(bucketCount, Bucket{0, 0});
+        uint64_t mask = bucketCount - 1;
+        for (uint64_t row = 0; row < count; ++row) {
+            uint64_t hash = hashName(catalog.items()[row].getName());
+            uint64_t pos = hash & mask;
+            while (index[pos].rowPlusOne != 0) {
+                pos = (pos + 1) & mask;
+            }
+            index[pos] = Bucket{static_cast<uint32_t>(hash >> 32), static_cast<uint32_t>(row + 1)};
+        }
+
+        const std::string tempName = filename + ".tmp";
+        int fd = ::open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+
+        std::vector<char> buffer;
+        buffer.reserve(1 << 20);
+        bool ok = true;
+        auto put = [&](const void* data, size_t bytes) {
+            if (buffer.size() + bytes > buffer.capacity()) {
+                ok = ok && writeAll(fd, buffer.data(), buffer.size());
+                buffer.clear();
+                if (bytes > buffer.capacity()) {
+                    ok = ok && writeAll(fd, data, bytes);
+                    return;
+                }
+            }
+            const char* bytesIn = static_cast<const char*>(data);
+            buffer.insert(buffer.end(), bytesIn, bytesIn + bytes);
+        };
+        auto padTo = [&](uint64_t offset, uint64_t& written) {
+            static const char zeros[8] = {};
+            put(zeros, offset - written);
+            written = offset;
+        };
+
+        uint64_t written = 0;
+        put(&out, sizeof(out));
+        written += sizeof(out);
+        padTo(out.pricesOffset, written);
+        for (const Product& product : catalog) {
+            int64_t price = product.getPrice().inCents();
+            put(&price, sizeof(price));
+        }
+        written += count * sizeof(int64_t);
+        padTo(out.stocksOffset, written);
+        for (const Product& product : catalog) {
+            int32_t stock = product.getStock();
+            put(&stock, sizeof(stock));
+        }
+        written += count * sizeof(int32_t);
+        padTo(out.nameOffsetsOffset, written);
+        uint64_t nameOffset = 0;
+        put(&nameOffset, sizeof(nameOffset));
+        for (const Product& product : catalog) {
+            nameOffset += product.getName().size();
+            put(&nameOffset, sizeof(nameOffset));
+        }
+        written += (count + 1) * sizeof(uint64_t);
+        padTo(out.bucketsOffset, written);
+        put(index.data(), index.size() * sizeof(Bucket));
+        for (const Product& product : catalog) {
+            put(product.getName().data(), product.getName().size());
+        }
+        ok = ok && writeAll(fd, buffer.data(), buffer.size());
+
+        return commitTempFile(fd, ok, tempName, filename);
+    }
+};
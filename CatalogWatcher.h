@@ -0,0 +1,193 @@
+#pragma once
+
+#include "CsvSync.h"
+#include "ShardedCatalog.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+// CatalogWatcher Class
+// Keeps a ShardedCatalog in step with products.csv from a background
+// thread. inotify watches the file's directory rather than the file, so a
+// feed replaced by rename (as most copy and sync tools do) is seen as well
+// as one rewritten in place. Once a burst of events has been quiet for
+// QUIET_MS the file is re-synced with CsvSync: it is parsed on the watcher
+// thread and the changes are published as one version, so browsing
+// sessions keep reading the previous version meanwhile and never block.
+//
+// The watcher mirrors the file: products no longer in it are removed.
+// Stock is not mirrored outright: a changed stock in the file moves the
+// live level by the same amount (see CsvSync), so units that sessions
+// reserved between reloads stay sold.
+class CatalogWatcher {
+public:
+    // Reload latency runs from the first change event of a burst to the
+    // new version being published (it includes the QUIET_MS wait);
+    // sync time is the parse-and-publish part alone.
+    struct Metrics {
+        uint64_t reloads = 0;    // syncs that read the file
+        uint64_t unchanged = 0;  // change events whose contents matched the last sync
+        uint64_t failures = 0;   // the file could not be opened
+        double lastLatencyMs = 0.0;
+        double maxLatencyMs = 0.0;
+        double totalLatencyMs = 0.0;
+        double lastSyncMs = 0.0;
+    };
+
+    static constexpr int QUIET_MS = 50;
+
+    // `csvSync` is shared with everything else that syncs this catalog
+    // (admin uploads); see CsvSync.
+    CatalogWatcher(ShardedCatalog& watched, std::string csvFile, std::shared_ptr<CsvSync> csvSync,
+                   std::ostream& logStream = std::cout)
+        : catalog(watched), filename(std::move(csvFile)), log(logStream), sync(std::move(csvSync)) {}
+
+    CatalogWatcher(ShardedCatalog& watched, std::string csvFile, std::ostream& logStream = std::cout)
+        : CatalogWatcher(watched, std::move(csvFile), std::make_shared<CsvSync>(), logStream) {}
+
+    CatalogWatcher(const CatalogWatcher&) = delete;
+    CatalogWatcher& operator=(const CatalogWatcher&) = delete;
+
+    ~CatalogWatcher() { stop(); }
+
+    // Brings the catalog in line with the file, then starts watching it.
+    // Returns false if the directory cannot be watched.
+    bool start() {
+        size_t slash = filename.rfind('/');
+        std::string directory = slash == std::string::npos ? "." : filename.substr(0, slash == 0 ? 1 : slash);
+        basename = slash == std::string::npos ? filename : filename.substr(slash + 1);
+
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (inotifyFd < 0 || stopFd < 0 ||
+            inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            closeFds();
+            return false;
+        }
+        reload(std::chrono::steady_clock::now());
+        thread = std::thread([this] { loop(); });
+        return true;
+    }
+
+    void stop() {
+        if (thread.joinable()) {
+            uint64_t one = 1;
+            [[maybe_unused]] ssize_t ignored = ::write(stopFd, &one, sizeof(one));
+            thread.join();
+        }
+        closeFds();
+    }
+
+    Metrics metrics() const {
+        std::lock_guard<std::mutex> lock(metricsMutex);
+        return counters;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    ShardedCatalog& catalog;
+    std::string filename;
+    std::string basename;
+    std::ostream& log;
+    std::shared_ptr<CsvSync> sync;
+    int inotifyFd = -1;
+    int stopFd = -1;
+    std::thread thread;
+    mutable std::mutex metricsMutex;
+    Metrics counters;
+
+    void closeFds() {
+        if (inotifyFd >= 0) {
+            ::close(inotifyFd);
+        }
+        if (stopFd >= 0) {
+            ::close(stopFd);
+        }
+        inotifyFd = stopFd = -1;
+    }
+
+    // Reads every queued event; returns true if one named the watched file.
+    bool drainEvents() {
+        alignas(inotify_event) char buffer[4096];
+        bool touched = false;
+        while (true) {
+            ssize_t length = ::read(inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0) {
+                return touched;  // EAGAIN once drained
+            }
+            for (ssize_t offset = 0; offset < length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                touched = touched || (event->len > 0 && basename == event->name);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            }
+        }
+    }
+
+    void loop() {
+        pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {stopFd, POLLIN, 0}};
+        bool pending = false;
+        Clock::time_point firstEvent;
+        while (true) {
+            int ready = ::poll(fds, 2, pending ? QUIET_MS : -1);
+            if (ready < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ready < 0 || (fds[1].revents & POLLIN)) {
+                return;
+            }
+            if (ready == 0) {
+                reload(firstEvent);
+                pending = false;
+                continue;
+            }
+            if (drainEvents() && !pending) {
+                pending = true;
+                firstEvent = Clock::now();
+            }
+        }
+    }
+
+    void reload(Clock::time_point changedAt) {
+        CsvSync::Stats stats;
+        unsigned threads = std::thread::hardware_concurrency();
+        Clock::time_point started = Clock::now();
+        bool opened = sync->sync(catalog, filename, true, stats, threads == 0 ? 1 : threads, log);
+        Clock::time_point done = Clock::now();
+        double latencyMs = std::chrono::duration<double, std::milli>(done - changedAt).count();
+        double syncMs = std::chrono::duration<double, std::milli>(done - started).count();
+
+        {
+            std::lock_guard<std::mutex> lock(metricsMutex);
+            if (!opened) {
+                ++counters.failures;
+            } else if (stats.skipped) {
+                ++counters.unchanged;
+            } else {
+                ++counters.reloads;
+                counters.lastLatencyMs = latencyMs;
+                counters.maxLatencyMs = std::max(counters.maxLatencyMs, latencyMs);
+                counters.totalLatencyMs += latencyMs;
+                counters.lastSyncMs = syncMs;
+            }
+        }
+        if (!opened) {
+            log << "Failed to reload " << filename << "\n";
+        } else if (!stats.skipped) {
+            log << "Reloaded " << filename << " in " << latencyMs << " ms: " << stats.inserted << " added, "
+                << stats.updated << " updated, " << stats.deleted << " removed\n";
+        }
+    }
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Catalog.h"
+#include "CatalogKernels.h"
+#include "Money.h"
+#include "StringArena.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// ColumnarCatalog Class
+// Struct-of-arrays copy of a Catalog for scan-heavy queries: prices (in
+// cents) and stock levels sit in their own contiguous arrays and names are interned
+// in a StringArena, so a filter over price/stock only touches 12 bytes per
+// product instead of dragging every std::string through the cache. Row i
+// of every column describes the product in slot i of the source catalog.
+//
+// Filters and inventory value run on CatalogKernels::best() (AVX2 where
+// the CPU has it); the remaining aggregates are plain branch-free loops.
+class ColumnarCatalog {
+    StringArena arena;
+    std::vector<std::string_view> names;
+    std::vector<int64_t> prices;  // cents
+    std::vector<int> stocks;
+    uint64_t builtVersion = 0;
+    bool built = false;
+
+public:
+    ColumnarCatalog() = default;
+    explicit ColumnarCatalog(const Catalog& catalog) { rebuild(catalog); }
+
+    void rebuild(const Catalog& catalog) {
+        arena.clear();
+        names.clear();
+        prices.clear();
+        stocks.clear();
+        names.reserve(catalog.size());
+        prices.reserve(catalog.size());
+        stocks.reserve(catalog.size());
+        for (const Product& product : catalog) {
+            names.push_back(arena.intern(product.getName()));
+            prices.push_back(product.getPrice().inCents());
+            stocks.push_back(product.getStock());
+        }
+        builtVersion = catalog.version();
+        built = true;
+    }
+
+    // Rebuilds only if the catalog changed since the last build.
+    void refresh(const Catalog& catalog) {
+        if (!built || builtVersion != catalog.version()) {
+            rebuild(catalog);
+        }
+    }
+
+    size_t size() const { return prices.size(); }
+    std::string_view nameAt(size_t row) const { return names[row]; }
+    Money priceAt(size_t row) const { return Money::fromCents(prices[row]); }
+    int stockAt(size_t row) const { return stocks[row]; }
+    const int64_t* priceData() const { return prices.data(); }
+    const int* stockData() const { return stocks.data(); }
+
+    // Rows with minPrice <= price <= maxPrice and stock >= minStock, in
+    // catalog order.
+    std::vector<uint32_t> filter(Money minPrice, Money maxPrice, int minStock) const {
+        std::vector<uint32_t> rows(prices.size());
+        size_t count = CatalogKernels::best().filterRange(prices.data(), stocks.data(), prices.size(),
+                                                          minPrice.inCents(), maxPrice.inCents(), minStock,
+                                                          rows.data());
+        rows.resize(count);
+        return rows;
+    }
+
+    // Rows whose stock is strictly below `threshold`, in catalog order.
+    std::vector<uint32_t> lowStock(int threshold) const {
+        std::vector<uint32_t> rows(stocks.size());
+        size_t count = CatalogKernels::best().lowStock(stocks.data(), stocks.size(), threshold, rows.data());
+        rows.resize(count);
+        return rows;
+    }
+
+    // Sum of price * stock over the whole catalog.
+    Money totalInventoryValue() const {
+        return Money::fromCents(CatalogKernels::best().inventoryValue(prices.data(), stocks.data(), prices.size()));
+    }
+
+    long long totalUnits() const {
+        long long units = 0;
+        for (size_t i = 0; i < stocks.size(); ++i) {
+            units += stocks[i];
+        }
+        return units;
+    }
+
+    // Number of products with stock strictly below `threshold`.
+    size_t countBelowStock(int threshold) const {
+        size_t count = 0;
+        for (size_t i = 0; i < stocks.size(); ++i) {
+            count += stocks[i] < threshold;
+        }
+        return count;
+    }
+};
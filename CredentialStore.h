@@ -0,0 +1,132 @@
+#pragma once
+
+#include "CsvImporter.h"
+#include "GroupCommitLog.h"
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+// Outcome of CredentialStore::registerAccount.
+enum class RegisterResult { Registered, UsernameTaken, InvalidName, StorageError };
+
+// CredentialStore Class
+// In-memory index of the "username,password" lines in accounts.txt. The
+// file is read once by load(); after that logins are a single hash lookup
+// and registrations are added to the index and appended to the file.
+//
+// The store is safe to share between threads. Registration claims the
+// username in the index under an exclusive lock (so two concurrent
+// signups for one name cannot both succeed) and then appends the line
+// through a GroupCommitLog outside the lock, so concurrent signups share
+// fsyncs. Until the append returns the claim is pending: it blocks other
+// signups for the name but cannot log in. If the append fails the claim is
+// rolled back.
+class CredentialStore {
+    // Transparent hash so lookups can take a string_view without building
+    // a temporary std::string.
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+
+    struct Account {
+        std::string password;
+        bool pending = false;  // claimed by a registration not yet on disk
+    };
+
+    std::string filename;
+    std::unordered_map<std::string, Account, NameHash, std::equal_to<>> accounts;
+    mutable std::shared_mutex indexMutex;
+    GroupCommitLog log;
+
+public:
+    explicit CredentialStore(std::string file) : filename(std::move(file)) {}
+
+    const std::string& getFilename() const { return filename; }
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(indexMutex);
+        return accounts.size();
+    }
+
+    // Loads every account in the file into the index. A missing file is
+    // treated as an empty store and created, ready for registrations.
+    // If a username appears more than once, the first entry wins.
+    // Must not run concurrently with other calls.
+    bool load() {
+        accounts.clear();
+        MappedFile file;
+        if (file.open(filename)) {
+            std::string_view data = file.view();
+            accounts.reserve(CsvImporter::countLines(data));
+
+            const char* pos = data.data();
+            const char* end = pos + data.size();
+            while (pos < end) {
+                const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+                const char* lineEnd = newline ? newline : end;
+                std::string_view line(pos, lineEnd - pos);
+                pos = newline ? newline + 1 : end;
+
+                if (!line.empty() && line.back() == '\r') {
+                    line.remove_suffix(1);
+                }
+                size_t comma = line.find(',');
+                if (line.empty() || comma == std::string_view::npos) {
+                    continue;
+                }
+                accounts.emplace(std::string(line.substr(0, comma)), Account{std::string(line.substr(comma + 1))});
+            }
+        }
+
+        return log.open(filename);
+    }
+
+    bool contains(std::string_view username) const {
+        std::shared_lock<std::shared_mutex> lock(indexMutex);
+        auto it = accounts.find(username);
+        return it != accounts.end() && !it->second.pending;
+    }
+
+    bool verify(std::string_view username, std::string_view password) const {
+        std::shared_lock<std::shared_mutex> lock(indexMutex);
+        auto it = accounts.find(username);
+        return it != accounts.end() && !it->second.pending && it->second.password == password;
+    }
+
+    // Atomically claims `username` and durably appends the account to the
+    // file. Blocks until the line is on disk. Names containing a comma or a
+    // newline (and passwords with a newline) would corrupt the file and are
+    // rejected as InvalidName.
+    RegisterResult registerAccount(const std::string& username, const std::string& password) {
+        if (username.empty() || username.find_first_of(",\n") != std::string::npos ||
+            password.find('\n') != std::string::npos) {
+            return RegisterResult::InvalidName;
+        }
+        {
+            std::unique_lock<std::shared_mutex> lock(indexMutex);
+            if (!accounts.emplace(username, Account{password, true}).second) {
+                return RegisterResult::UsernameTaken;
+            }
+        }
+
+        std::string line;
+        line.reserve(username.size() + password.size() + 2);
+        line.append(username).append(1, ',').append(password).append(1, '\n');
+        bool durable = log.append(line);
+        std::unique_lock<std::shared_mutex> lock(indexMutex);
+        if (!durable) {
+            accounts.erase(username);
+            return RegisterResult::StorageError;
+        }
+        accounts.find(username)->second.pending = false;
+        return RegisterResult::Registered;
+    }
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Catalog.h"
+#include "CsvImporter.h"
+#include "FileUtil.h"
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+
+// CsvExporter Class
+// Writes the catalog as products.csv. Rows are formatted with std::to_chars
+// into one reusable buffer that is written out in large blocks, and the
+// target is replaced atomically: everything goes to "<file>.tmp", which is
+// fsync'd and then renamed over the original, so a crash mid-save never
+// leaves a truncated catalog behind.
+class CsvExporter {
+    static constexpr size_t BUFFER_BYTES = 1 << 20;
+    // Longest price/stock text plus separators: prices need at most
+    // Money::MAX_CHARS characters, ints 11.
+    static constexpr size_t MAX_NUMBERS_BYTES = Money::MAX_CHARS + 11 + 3;
+
+    std::vector<char> buffer;  // allocated on first export, then reused
+    size_t used = 0;
+    int fd = -1;
+    bool failed = false;
+
+    void flush() {
+        if (used > 0 && !failed) {
+            failed = !writeAll(fd, buffer.data(), used);
+        }
+        used = 0;
+    }
+
+    void append(std::string_view text) {
+        if (text.size() > buffer.size() - used) {
+            flush();
+            if (text.size() > buffer.size()) {
+                failed = failed || !writeAll(fd, text.data(), text.size());
+                return;
+            }
+        }
+        std::memcpy(buffer.data() + used, text.data(), text.size());
+        used += text.size();
+    }
+
+    void appendRow(const Product& product) {
+        append(product.getName());
+        if (buffer.size() - used < MAX_NUMBERS_BYTES) {
+            flush();
+        }
+        char* out = buffer.data() + used;
+        char* end = buffer.data() + buffer.size();
+        *out++ = ',';
+        out = product.getPrice().format(out, end);
+        *out++ = ',';
+        out = std::to_chars(out, end, product.getStock()).ptr;
+        *out++ = '\n';
+        used = static_cast<size_t>(out - buffer.data());
+    }
+
+public:
+    // Writes every product (with the CSV header) to `filename`. Returns
+    // false, leaving any existing file untouched, if the write fails.
+    bool exportFile(const Catalog& catalog, const std::string& filename) {
+        const std::string tempName = filename + ".tmp";
+        fd = ::open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        buffer.resize(BUFFER_BYTES);
+        used = 0;
+        failed = false;
+
+        append(CsvImporter::HEADER);
+        append("\n");
+        for (const Product& product : catalog) {
+            appendRow(product);
+        }
+        flush();
+
+        bool ok = commitTempFile(fd, !failed, tempName, filename);
+        fd = -1;
+        return ok;
+    }
+};
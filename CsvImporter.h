@@ -0,0 +1,246 @@
+#pragma once
+
+#include "Catalog.h"
+#include "MappedFile.h"
+#include "Money.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// One parsed "name,price,stock" row. The name points into the source buffer.
+struct CsvRow {
+    std::string_view name;
+    Money price;
+    int stock = 0;
+};
+
+enum class CsvRowStatus { Ok, Blank, BadPrice, BadStock };
+
+// CsvImporter Class
+// Streaming products.csv importer. The file is memory-mapped, rows are
+// tokenized in place with string_view, prices are parsed straight to
+// cents (Money::parse) and stock with std::from_chars, and names are
+// copied once, into the catalog's name arena, so rows cost no heap
+// allocation of their own. Large files can be split across worker threads.
+class CsvImporter {
+public:
+    static constexpr std::string_view HEADER = "Product Name,Price,Stock";
+
+    struct Stats {
+        size_t rowsImported = 0;
+        size_t badLines = 0;
+    };
+
+    static std::string_view trim(std::string_view field) {
+        while (!field.empty() && (field.front() == ' ' || field.front() == '\t')) {
+            field.remove_prefix(1);
+        }
+        while (!field.empty() && (field.back() == ' ' || field.back() == '\t' || field.back() == '\r')) {
+            field.remove_suffix(1);
+        }
+        return field;
+    }
+
+    static CsvRowStatus parseRow(std::string_view line, CsvRow& row) {
+        line = trim(line);
+        if (line.empty()) {
+            return CsvRowStatus::Blank;
+        }
+
+        size_t firstComma = line.find(',');
+        if (firstComma == std::string_view::npos) {
+            return CsvRowStatus::BadPrice;
+        }
+        row.name = line.substr(0, firstComma);
+        std::string_view rest = line.substr(firstComma + 1);
+
+        size_t secondComma = rest.find(',');
+        if (!Money::parse(trim(rest.substr(0, secondComma)), row.price)) {
+            return CsvRowStatus::BadPrice;
+        }
+
+        if (secondComma == std::string_view::npos) {
+            return CsvRowStatus::BadStock;
+        }
+        std::string_view stockField = trim(rest.substr(secondComma + 1));
+        const char* stockEnd = stockField.data() + stockField.size();
+        auto stockResult = std::from_chars(stockField.data(), stockEnd, row.stock);
+        if (stockField.empty() || stockResult.ec != std::errc() || stockResult.ptr != stockEnd) {
+            return CsvRowStatus::BadStock;
+        }
+        return CsvRowStatus::Ok;
+    }
+
+    static size_t countLines(std::string_view data) {
+        size_t lines = 0;
+        const char* pos = data.data();
+        const char* end = pos + data.size();
+        while (pos < end) {
+            const void* newline = std::memchr(pos, '\n', end - pos);
+            ++lines;
+            if (newline == nullptr) {
+                break;
+            }
+            pos = static_cast<const char*>(newline) + 1;
+        }
+        return lines;
+    }
+
+    // Walks `data` line by line, calling onRow(const CsvRow&) for every valid
+    // row and onBadLine(std::string_view line, CsvRowStatus) for malformed
+    // ones. A leading "Product Name,Price,Stock" header is skipped unless
+    // `data` is a chunk from the middle of a file.
+    template <typename OnRow, typename OnBadLine>
+    static void parse(std::string_view data, OnRow&& onRow, OnBadLine&& onBadLine,
+                      bool skipHeader = true) {
+        const char* pos = data.data();
+        const char* end = pos + data.size();
+        bool firstLine = skipHeader;
+        CsvRow row;
+
+        while (pos < end) {
+            const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+            const char* lineEnd = newline ? newline : end;
+            std::string_view line(pos, lineEnd - pos);
+            pos = newline ? newline + 1 : end;
+
+            if (firstLine) {
+                firstLine = false;
+                if (trim(line) == HEADER) {
+                    continue;
+                }
+            }
+
+            CsvRowStatus status = parseRow(line, row);
+            if (status == CsvRowStatus::Ok) {
+                onRow(row);
+            } else if (status != CsvRowStatus::Blank) {
+                onBadLine(line, status);
+            }
+        }
+    }
+
+    // Writes the message for a bad line to `log` (the requesting session's
+    // output in server mode).
+    static void reportBadLine(std::ostream& log, std::string_view line, CsvRowStatus status) {
+        const char* field = status == CsvRowStatus::BadPrice ? "price" : "stock";
+        log << "Invalid format for " << field << " in line: " << trim(line) << "\n";
+    }
+
+    // Imports every row of `filename` into the catalog. Rows naming an
+    // existing product overwrite its price and stock. With more than one
+    // thread, large files are parsed in parallel (see importChunked). Bad
+    // lines are reported to `log`. Returns false if the file could not be
+    // opened.
+    static bool importFile(Catalog& catalog, const std::string& filename, Stats& stats,
+                           unsigned threads = 1, std::ostream& log = std::cout) {
+        MappedFile file;
+        if (!file.open(filename)) {
+            return false;
+        }
+        std::string_view data = file.view();
+        catalog.reserve(catalog.size() + countLines(data));
+
+        if (threads > 1 && data.size() >= 2 * MIN_CHUNK_BYTES) {
+            importChunked(catalog, data, stats, threads, log);
+            return true;
+        }
+
+        parse(
+            data,
+            [&](const CsvRow& row) {
+                catalog.insertOrAssign(Product(row.name, row.price, row.stock));
+                ++stats.rowsImported;
+            },
+            [&](std::string_view line, CsvRowStatus status) {
+                reportBadLine(log, line, status);
+                ++stats.badLines;
+            });
+        return true;
+    }
+
+    // Chunks smaller than this are not worth a thread of their own.
+    static constexpr size_t MIN_CHUNK_BYTES = 1 << 20;
+
+    // Splits `data` into up to `parts` pieces, each ending on a newline.
+    static std::vector<std::string_view> splitAtNewlines(std::string_view data, size_t parts) {
+        std::vector<std::string_view> chunks;
+        size_t target = data.size() / parts;
+        size_t begin = 0;
+        for (size_t i = 1; i < parts && begin < data.size(); ++i) {
+            size_t cut = std::max(begin, i * target);
+            size_t newline = data.find('\n', cut);
+            size_t end = newline == std::string_view::npos ? data.size() : newline + 1;
+            chunks.push_back(data.substr(begin, end - begin));
+            begin = end;
+        }
+        if (begin < data.size()) {
+            chunks.push_back(data.substr(begin));
+        }
+        return chunks;
+    }
+
+private:
+    // Rows parsed by one worker, ready to be merged into the catalog.
+    struct ParsedChunk {
+        std::vector<Product> products;
+        std::vector<uint32_t> hashes;
+        std::vector<std::pair<std::string_view, CsvRowStatus>> badLines;
+    };
+
+    // Parallel path: each worker parses its newline-aligned chunk into a
+    // local buffer (Products viewing their names in the mapped file, plus
+    // the name hashes), then the buffers are merged into the catalog in
+    // file order so the result is identical to a sequential import.
+    static void importChunked(Catalog& catalog, std::string_view data, Stats& stats,
+                              unsigned threads, std::ostream& log) {
+        size_t parts = std::min<size_t>(threads, data.size() / MIN_CHUNK_BYTES);
+        std::vector<std::string_view> chunks = splitAtNewlines(data, parts);
+        std::vector<ParsedChunk> parsed(chunks.size());
+
+        auto work = [&](size_t index) {
+            ParsedChunk& out = parsed[index];
+            out.products.reserve(countLines(chunks[index]));
+            out.hashes.reserve(out.products.capacity());
+            parse(
+                chunks[index],
+                [&](const CsvRow& row) {
+                    out.hashes.push_back(Catalog::hashName(row.name));
+                    out.products.emplace_back(row.name, row.price, row.stock);
+                },
+                [&](std::string_view line, CsvRowStatus status) {
+                    out.badLines.emplace_back(line, status);
+                },
+                index == 0);
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < chunks.size(); ++i) {
+            workers.emplace_back(work, i);
+        }
+        work(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        for (ParsedChunk& chunk : parsed) {
+            for (const auto& [line, status] : chunk.badLines) {
+                reportBadLine(log, line, status);
+            }
+            stats.badLines += chunk.badLines.size();
+            for (size_t i = 0; i < chunk.products.size(); ++i) {
+                catalog.insertOrAssign(std::move(chunk.products[i]), chunk.hashes[i]);
+            }
+            stats.rowsImported += chunk.products.size();
+            chunk = ParsedChunk();  // release the worker's buffer as we go
+        }
+    }
+};
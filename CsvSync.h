@@ -0,0 +1,351 @@
+#pragma once
+
+#include "Catalog.h"
+#include "CsvImporter.h"
+#include "MappedFile.h"
+#include "ShardedCatalog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/stat.h>
+
+// CsvSync Class
+// Re-syncs a catalog with products.csv as a delta keyed by product name:
+// new names are inserted, products whose row changed since the last feed
+// are updated in place, and (optionally) products missing from the file
+// are erased. Rows are looked up on worker threads and rows that match the
+// last feed are only read, never written, so re-syncing a large feed with
+// a small change writes just the changed products.
+//
+// Rows are compared with the last values this CsvSync applied per product
+// id, not with the live catalog: checkouts lower stock between syncs, and
+// those units must stay sold. A changed stock is applied as a delta
+// against the last feed value (see Catalog::adjust), so a feed adding 5
+// units adds 5 to whatever is left. A product with no feed value yet (the
+// first time this CsvSync sees it) takes the row's price but keeps its
+// live stock, and the row becomes its baseline.
+//
+// The baselines are what make deltas right, so every writer syncing one
+// catalog (each admin session and the file watcher) must share a single
+// CsvSync; with one each, a change would be applied once per instance.
+// Syncs on a shared instance run one at a time. Baselines are keyed by
+// product id, so the instance also carries over to a ShardedCatalog
+// seeded with publishWithIds().
+//
+// The last file applied is remembered by size, mtime and a 64-bit hash of
+// its contents. A file whose size and mtime are unchanged is skipped
+// without being read; one rewritten with the same contents is read once to
+// hash it, then skipped. Edits made to the catalog by other means since
+// the last sync are not undone by a skipped file.
+class CsvSync {
+public:
+    struct Stats {
+        size_t inserted = 0;
+        size_t updated = 0;
+        size_t unchanged = 0;
+        size_t deleted = 0;
+        size_t badLines = 0;
+        bool skipped = false;  // the file had not changed since the last sync
+    };
+
+    // Forgets the last file applied, so the next sync reads it in full even
+    // if it is unchanged. Call it when the catalog was replaced wholesale
+    // (e.g. a snapshot load). The feed baselines are kept: ids are stable,
+    // so they still describe what the file last said about each product.
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        last = Stamp();
+    }
+
+    // Applies `filename` to the catalog. With deleteMissing, products not
+    // named in the file are erased. Bad lines are reported to `log`.
+    // Returns false if the file could not be opened.
+    bool sync(Catalog& catalog, const std::string& filename, bool deleteMissing, Stats& stats,
+              unsigned threads = 1, std::ostream& log = std::cout) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return run(filename, deleteMissing, stats, [&](std::string_view data) {
+            Marks seen(deleteMissing ? catalog.idLimit() : 0);
+            const Catalog& view = catalog;
+            auto find = [&](std::string_view name, uint32_t hash) { return view.find(name, hash); };
+            for (const Change& change : classify(data, threads, find, feed, seen, stats, log)) {
+                uint32_t id = change.id;
+                Catalog::Upsert result =
+                    id == NEW_PRODUCT
+                        ? catalog.upsert(change.row.name, change.row.price, change.row.stock, change.hash, id)
+                        : catalog.adjust(id, change.row.price, stockDelta(change));
+                switch (result) {
+                    case Catalog::Upsert::Inserted: ++stats.inserted; break;
+                    case Catalog::Upsert::Updated: ++stats.updated; break;
+                    case Catalog::Upsert::Unchanged: ++stats.unchanged; break;
+                }
+                remember(id, change.row);
+            }
+            if (deleteMissing) {
+                std::vector<std::string> missing;
+                for (const Product& product : catalog) {
+                    if (product.getId() < seen.size() && !seen[product.getId()].load(std::memory_order_relaxed)) {
+                        missing.emplace_back(product.getName());
+                    }
+                }
+                for (const std::string& name : missing) {
+                    stats.deleted += catalog.erase(name);
+                }
+            }
+        });
+    }
+
+    // Same for a ShardedCatalog: the changed rows and erasures are published
+    // as one version, so readers see all of the sync or none of it, and a
+    // sync that changes nothing publishes nothing.
+    bool sync(ShardedCatalog& catalog, const std::string& filename, bool deleteMissing, Stats& stats,
+              unsigned threads = 1, std::ostream& log = std::cout) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return run(filename, deleteMissing, stats, [&](std::string_view data) {
+            Marks seen(deleteMissing ? catalog.idLimit() : 0);
+            std::vector<Product> upserts;
+            std::vector<ShardedCatalog::Adjustment> adjustments;
+            std::vector<std::string> erasures;
+            {
+                ShardedCatalog::Reader view = catalog.read();
+                auto find = [&](std::string_view name, uint32_t hash) { return view.find(name, hash); };
+                for (const Change& change : classify(data, threads, find, feed, seen, stats, log)) {
+                    if (change.id == NEW_PRODUCT) {
+                        upserts.emplace_back(change.row.name, change.row.price, change.row.stock);
+                        continue;
+                    }
+                    adjustments.push_back({change.row.name, change.row.price, stockDelta(change)});
+                    remember(change.id, change.row);
+                }
+                if (deleteMissing) {
+                    for (const CatalogItem& item : view) {
+                        if (item.getId() < seen.size() && !seen[item.getId()].load(std::memory_order_relaxed)) {
+                            erasures.push_back(item.getName());
+                        }
+                    }
+                }
+            }
+            if (upserts.empty() && erasures.empty() && adjustments.empty()) {
+                return;
+            }
+            ShardedCatalog::PublishStats published = catalog.publish(upserts, erasures, adjustments);
+            stats.inserted += published.inserted;
+            stats.updated += published.updated;
+            stats.unchanged += published.unchanged;
+            stats.deleted += published.erased;
+            if (!upserts.empty()) {
+                ShardedCatalog::Reader view = catalog.read();
+                for (const Product& product : upserts) {
+                    if (const CatalogItem* item = view.find(product.getName())) {
+                        remember(item->getId(), CsvRow{product.getName(), product.getPrice(), product.getStock()});
+                    }
+                }
+            }
+        });
+    }
+
+    // 64-bit content hash: four independent multiply-rotate lanes (the
+    // xxHash64 round), so a large feed hashes at close to memory bandwidth.
+    // Not cryptographic; it only has to tell a changed feed from the last one.
+    static uint64_t hashContents(std::string_view data) {
+        constexpr uint64_t P1 = 0x9E3779B185EBCA87ull;
+        constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4Full;
+        auto round = [](uint64_t acc, uint64_t word) {
+            acc += word * P2;
+            acc = (acc << 31) | (acc >> 33);
+            return acc * P1;
+        };
+        uint64_t lanes[4] = {P1 + P2, P2, 0, 0 - P1};
+        const char* pos = data.data();
+        size_t remaining = data.size();
+        for (; remaining >= 32; pos += 32, remaining -= 32) {
+            for (size_t lane = 0; lane < 4; ++lane) {
+                uint64_t word;
+                std::memcpy(&word, pos + lane * 8, 8);
+                lanes[lane] = round(lanes[lane], word);
+            }
+        }
+        uint64_t hash = data.size();
+        for (size_t lane = 0; lane < 4; ++lane) {
+            hash = round(hash, lanes[lane]);
+        }
+        for (; remaining > 0; ++pos, --remaining) {
+            hash = round(hash, static_cast<unsigned char>(*pos));
+        }
+        hash ^= hash >> 33;
+        hash *= P2;
+        hash ^= hash >> 29;
+        return hash;
+    }
+
+private:
+    struct Stamp {
+        std::string filename;
+        uint64_t size = 0;
+        int64_t mtimeNanos = 0;
+        uint64_t contentHash = 0;
+        bool deletedMissing = false;  // that sync also erased missing products
+        bool valid = false;
+    };
+
+    static constexpr uint32_t NEW_PRODUCT = UINT32_MAX;
+
+    // A row that is new or differs from the last feed.
+    struct Change {
+        CsvRow row;  // name points into the mapped file
+        uint32_t hash;
+        uint32_t id;  // existing product, or NEW_PRODUCT
+    };
+
+    // The last row applied for a product id.
+    struct FeedValue {
+        Money price;
+        int stock = 0;
+        bool known = false;
+    };
+
+    // One worker's share of classify().
+    struct ChunkResult {
+        std::vector<Change> changes;
+        std::vector<std::pair<std::string_view, CsvRowStatus>> badLines;
+        size_t unchanged = 0;
+    };
+
+    // Per-id "named in the file" flags, set concurrently by the workers.
+    using Marks = std::vector<std::atomic<uint8_t>>;
+
+    std::mutex mutex;  // serializes syncs and reset() on a shared instance
+    Stamp last;
+    std::vector<FeedValue> feed;  // indexed by product id
+
+    // Stock change of an existing product's row against its last feed
+    // value; none if it has no feed value yet.
+    int64_t stockDelta(const Change& change) const {
+        if (change.id >= feed.size() || !feed[change.id].known) {
+            return 0;
+        }
+        return int64_t(change.row.stock) - feed[change.id].stock;
+    }
+
+    void remember(uint32_t id, const CsvRow& row) {
+        if (id >= feed.size()) {
+            feed.resize(std::max<size_t>(size_t(id) + 1, feed.size() * 2));
+        }
+        feed[id] = FeedValue{row.price, row.stock, true};
+    }
+
+    // Checks the file against the last stamp and calls apply(contents) only
+    // if it changed.
+    template <typename Apply>
+    bool run(const std::string& filename, bool deleteMissing, Stats& stats, Apply apply) {
+        struct stat info;
+        if (::stat(filename.c_str(), &info) != 0) {
+            return false;
+        }
+        Stamp stamp;
+        stamp.filename = filename;
+        stamp.size = static_cast<uint64_t>(info.st_size);
+        stamp.mtimeNanos = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+        stamp.deletedMissing = deleteMissing;
+        stamp.valid = true;
+
+        // A sync that deleted missing products also covers one that would not.
+        bool covered = last.valid && last.filename == filename && (last.deletedMissing || !deleteMissing);
+        if (covered && last.size == stamp.size && last.mtimeNanos == stamp.mtimeNanos) {
+            stats.skipped = true;
+            return true;
+        }
+
+        MappedFile file;
+        if (!file.open(filename)) {
+            return false;
+        }
+        stamp.size = file.size();
+        stamp.contentHash = hashContents(file.view());
+        if (covered && last.size == stamp.size && last.contentHash == stamp.contentHash) {
+            stamp.deletedMissing = last.deletedMissing;
+            last = stamp;
+            stats.skipped = true;
+            return true;
+        }
+
+        apply(file.view());
+        last = stamp;
+        return true;
+    }
+
+    // Parses `data` and looks every row up with find(name, hash), which
+    // returns a product-like pointer or nullptr; with more than one thread
+    // large files are split as in CsvImporter. Rows that match their
+    // product's last feed value are counted as unchanged and the rest
+    // returned in file order. Every
+    // existing product named in the file is flagged in `seen` (when sized).
+    // Bad lines are reported to `log` in file order.
+    template <typename Find>
+    static std::vector<Change> classify(std::string_view data, unsigned threads, Find& find,
+                                        const std::vector<FeedValue>& feed, Marks& seen, Stats& stats,
+                                        std::ostream& log) {
+        std::vector<std::string_view> chunks{data};
+        if (threads > 1 && data.size() >= 2 * CsvImporter::MIN_CHUNK_BYTES) {
+            chunks = CsvImporter::splitAtNewlines(
+                data, std::min<size_t>(threads, data.size() / CsvImporter::MIN_CHUNK_BYTES));
+        }
+        std::vector<ChunkResult> results(chunks.size());
+
+        auto work = [&](size_t index) {
+            ChunkResult& out = results[index];
+            CsvImporter::parse(
+                chunks[index],
+                [&](const CsvRow& row) {
+                    uint32_t hash = Catalog::hashName(row.name);
+                    const auto* existing = find(row.name, hash);
+                    if (!existing) {
+                        out.changes.push_back(Change{row, hash, NEW_PRODUCT});
+                        return;
+                    }
+                    uint32_t id = existing->getId();
+                    if (id < seen.size()) {
+                        seen[id].store(1, std::memory_order_relaxed);
+                    }
+                    if (id < feed.size() && feed[id].known && feed[id].price == row.price &&
+                        feed[id].stock == row.stock) {
+                        ++out.unchanged;
+                        return;
+                    }
+                    out.changes.push_back(Change{row, hash, id});
+                },
+                [&](std::string_view line, CsvRowStatus status) { out.badLines.emplace_back(line, status); },
+                index == 0);
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < chunks.size(); ++i) {
+            workers.emplace_back(work, i);
+        }
+        work(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        std::vector<Change> changes;
+        for (ChunkResult& result : results) {
+            for (const auto& [line, status] : result.badLines) {
+                CsvImporter::reportBadLine(log, line, status);
+            }
+            stats.badLines += result.badLines.size();
+            stats.unchanged += result.unchanged;
+            changes.insert(changes.end(), result.changes.begin(), result.changes.end());
+        }
+        return changes;
+    }
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// EpochDomain Class
+// Epoch-based reclamation for read-mostly structures that are replaced by
+// publishing a new version through an atomic pointer (RCU style). Readers
+// pin the current epoch for the duration of a read with a Guard; writers
+// retire() what they unlinked, and it is freed once every reader that could
+// still be looking at it has finished.
+//
+// Readers never wait on writers: entering a read is one slot claim and two
+// stores. Unlinking must happen before retire(), with the pointer stores
+// and loads the reader relies on done in seq_cst order.
+class EpochDomain {
+    static constexpr size_t MAX_READERS = 256;
+    static constexpr uint64_t IDLE = 0;
+
+    struct alignas(64) Slot {
+        std::atomic<bool> claimed{false};
+        std::atomic<uint64_t> epoch{IDLE};  // epoch observed on entry, IDLE when free
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        void* pointer;
+        void (*destroy)(void*);
+    };
+
+    Slot slots[MAX_READERS];
+    std::atomic<uint64_t> globalEpoch{1};
+    std::mutex retiredMutex;
+    std::vector<Retired> retired;
+
+    size_t claimSlot() {
+        // Start at a per-thread position so concurrent readers rarely race
+        // for the same slot.
+        size_t start = std::hash<std::thread::id>{}(std::this_thread::get_id()) % MAX_READERS;
+        while (true) {
+            for (size_t i = 0; i < MAX_READERS; ++i) {
+                size_t index = (start + i) % MAX_READERS;
+                bool expected = false;
+                if (!slots[index].claimed.load(std::memory_order_relaxed) &&
+                    slots[index].claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    return index;
+                }
+            }
+            std::this_thread::yield();  // more than MAX_READERS concurrent reads
+        }
+    }
+
+    // Oldest epoch any active reader entered in, or UINT64_MAX if none.
+    uint64_t oldestActiveEpoch() const {
+        uint64_t oldest = UINT64_MAX;
+        for (const Slot& slot : slots) {
+            uint64_t epoch = slot.epoch.load();
+            if (epoch != IDLE && epoch < oldest) {
+                oldest = epoch;
+            }
+        }
+        return oldest;
+    }
+
+public:
+    // Pins the domain for as long as it lives; anything reachable when the
+    // guard was created stays valid until it is destroyed.
+    class Guard {
+        EpochDomain* domain = nullptr;
+        size_t slot = 0;
+
+    public:
+        explicit Guard(EpochDomain& owner) : domain(&owner), slot(owner.claimSlot()) {
+            domain->slots[slot].epoch.store(domain->globalEpoch.load());
+        }
+        Guard(Guard&& other) noexcept : domain(other.domain), slot(other.slot) { other.domain = nullptr; }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+
+        ~Guard() {
+            if (domain) {
+                domain->slots[slot].epoch.store(IDLE, std::memory_order_release);
+                domain->slots[slot].claimed.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    EpochDomain() = default;
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // Frees everything still pending; no reader may be active.
+    ~EpochDomain() {
+        for (const Retired& item : retired) {
+            item.destroy(item.pointer);
+        }
+    }
+
+    Guard pin() { return Guard(*this); }
+
+    // Schedules `pointer` (already unreachable for new readers) for deletion.
+    template <typename T>
+    void retire(const T* pointer) {
+        if (pointer == nullptr) {
+            return;
+        }
+        uint64_t epoch = globalEpoch.fetch_add(1);
+        std::lock_guard<std::mutex> lock(retiredMutex);
+        retired.push_back(Retired{epoch, const_cast<T*>(pointer),
+                                  [](void* p) { delete static_cast<T*>(p); }});
+    }
+
+    // Frees retired objects no active reader can still reach. Returns how
+    // many were freed.
+    size_t collect() {
+        uint64_t oldest = oldestActiveEpoch();
+        std::vector<Retired> ready;
+        {
+            std::lock_guard<std::mutex> lock(retiredMutex);
+            size_t kept = 0;
+            for (const Retired& item : retired) {
+                if (item.epoch < oldest) {
+                    ready.push_back(item);
+                } else {
+                    retired[kept++] = item;
+                }
+            }
+            retired.resize(kept);
+        }
+        for (const Retired& item : ready) {
+            item.destroy(item.pointer);
+        }
+        return ready.size();
+    }
+
+    size_t pending() {
+        std::lock_guard<std::mutex> lock(retiredMutex);
+        return retired.size();
+    }
+};
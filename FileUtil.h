@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include <unistd.h>
+
+// Small POSIX file helpers shared by the exporters and logs.
+
+// Writes all `length` bytes, retrying short writes and EINTR.
+inline bool writeAll(int fd, const void* data, size_t length) {
+    const char* bytes = static_cast<const char*>(data);
+    while (length > 0) {
+        ssize_t written = ::write(fd, bytes, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Finishes a write-temp-then-rename save: syncs and closes `fd` (open on
+// `tempName`) and, if everything succeeded so far, renames it over
+// `filename`. On any failure the temp file is removed and the target is
+// left untouched.
+inline bool commitTempFile(int fd, bool writesOk, const std::string& tempName,
+                           const std::string& filename) {
+    bool ok = writesOk && ::fsync(fd) == 0;
+    ok = (::close(fd) == 0) && ok;
+    if (ok) {
+        ok = std::rename(tempName.c_str(), filename.c_str()) == 0;
+    }
+    if (!ok) {
+        ::unlink(tempName.c_str());
+    }
+    return ok;
+}
@@ -0,0 +1,340 @@
+#pragma once
+
+#include "Catalog.h"
+#include "StringArena.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// FuzzyMatcher Class
+// Approximate product-name lookup, for names typed with a typo or two
+// ("Lapto" -> "Laptop"). Each lower-cased name is cut into overlapping
+// trigrams, padded so the start and end of the name form trigrams too, and
+// an inverted index maps every (trigram, name length) pair to the ids of
+// the names containing it.
+//
+// A query matches names at most maxEdits() insertions, deletions or
+// substitutions (k) away. Candidates come from a q-gram filter: an edit
+// destroys at most one of several non-overlapping trigrams, so a name
+// within k edits keeps at least one of any k + 1 non-overlapping query
+// trigrams. The query picks the k + 1 whose lists (restricted to names
+// within k characters of its length) are shortest in total, and only the
+// ids on those lists are considered. Each candidate is then checked
+// against a 128-bit trigram signature (a name within k edits lacks at most
+// 3k of the query's trigrams) and finally verified with an edit distance
+// computed on the k-wide band only.
+//
+// Like ProductSearch, the index only grows: refresh() picks up the ids a
+// Catalog has handed out since the last call, and queries skip ids the
+// caller reports as no longer live.
+class FuzzyMatcher {
+public:
+    struct Match {
+        uint32_t id;
+        unsigned distance;  // edits between the query and the name, ignoring case
+    };
+
+    static constexpr unsigned MAX_EDITS = 2;
+
+    // Edits tolerated for a query of `length` characters: none for very
+    // short queries, where almost anything is one edit away.
+    static unsigned maxEdits(size_t length) { return length < 3 ? 0 : (length <= 5 ? 1 : MAX_EDITS); }
+
+private:
+    struct GramBucket {
+        uint32_t key;  // see postingKey()
+        int32_t list;  // index into postings, or EMPTY
+    };
+
+    static constexpr int32_t EMPTY = -1;
+    static constexpr char PAD = '\0';
+
+    // Posting lists of one query trigram, one per name length in range.
+    struct GramLists {
+        const std::vector<uint32_t>* lists[2 * MAX_EDITS + 1];
+        size_t count = 0;
+        size_t postings = 0;  // ids on all of them
+    };
+
+    // Bloom-style summary of a name's trigrams: one bit per trigram hash.
+    struct Signature {
+        uint64_t bits[2] = {0, 0};
+
+        void add(uint32_t gram) {
+            unsigned bit = (gram * 0x85EBCA6Bu) >> 25;
+            bits[bit >> 6] |= uint64_t{1} << (bit & 63);
+        }
+        // Trigrams of `query` certainly missing from the name (a lower bound).
+        unsigned missingFrom(const Signature& query) const {
+            return static_cast<unsigned>(std::popcount(query.bits[0] & ~bits[0]) +
+                                         std::popcount(query.bits[1] & ~bits[1]));
+        }
+    };
+
+    StringArena arena;
+    std::vector<std::string_view> names;  // lower-cased name by id; empty if not indexed
+    std::vector<Signature> signatures;    // by id
+    std::vector<GramBucket> buckets = std::vector<GramBucket>(1024, GramBucket{0, EMPTY});
+    unsigned bucketBits = 10;
+    std::vector<std::vector<uint32_t>> postings;  // ids by trigram and name length, in increasing order
+    uint32_t indexedUpTo = 0;  // catalog ids below this have been indexed
+    size_t nameCount = 0;
+
+    // Query scratch, kept between calls.
+    std::vector<uint8_t> seen;  // by id; all zero between queries
+    std::vector<uint32_t> touched;
+    std::vector<unsigned> row;
+    std::string scratch;
+
+    static char lower(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+    const std::string& lowered(std::string_view text) {
+        scratch.resize(text.size());
+        std::transform(text.begin(), text.end(), scratch.begin(), lower);
+        return scratch;
+    }
+
+    static uint32_t pack(char a, char b, char c) {
+        return (uint32_t{static_cast<unsigned char>(a)} << 16) | (uint32_t{static_cast<unsigned char>(b)} << 8) |
+               uint32_t{static_cast<unsigned char>(c)};
+    }
+
+    // Calls fn(trigram) for each trigram of `key` padded as "\0\0key\0",
+    // left to right.
+    template <typename Fn>
+    static void forEachGram(std::string_view key, Fn fn) {
+        auto at = [&](size_t i) { return (i < 2 || i - 2 >= key.size()) ? PAD : key[i - 2]; };
+        for (size_t i = 0; i < key.size() + 1; ++i) {
+            fn(pack(at(i), at(i + 1), at(i + 2)));
+        }
+    }
+
+    // Starts of `count` trigrams that pairwise do not overlap (starts at
+    // least three apart) with the fewest postings in total, by dynamic
+    // programming over the start positions. All starts if the query is too
+    // short to hold `count`.
+    static std::vector<size_t> cheapestDisjoint(const std::vector<GramLists>& grams, size_t count) {
+        const size_t n = grams.size();
+        const size_t unreachable = SIZE_MAX;
+        // cost[i * (count + 1) + c]: cheapest c trigrams starting at i or later.
+        std::vector<size_t> cost((n + 3) * (count + 1), unreachable);
+        for (size_t i = 0; i < n + 3; ++i) {
+            cost[i * (count + 1)] = 0;
+        }
+        for (size_t i = n; i-- > 0;) {
+            for (size_t c = 1; c <= count; ++c) {
+                size_t skip = cost[(i + 1) * (count + 1) + c];
+                size_t rest = cost[(i + 3) * (count + 1) + c - 1];
+                size_t take = rest == unreachable ? unreachable : rest + grams[i].postings;
+                cost[i * (count + 1) + c] = std::min(skip, take);
+            }
+        }
+
+        std::vector<size_t> starts;
+        if (cost[count] == unreachable) {
+            for (size_t i = 0; i < n; ++i) {
+                starts.push_back(i);
+            }
+            return starts;
+        }
+        for (size_t i = 0, c = count; c > 0;) {
+            if (cost[i * (count + 1) + c] == cost[(i + 1) * (count + 1) + c]) {
+                ++i;
+            } else {
+                starts.push_back(i);
+                i += 3;
+                --c;
+            }
+        }
+        return starts;
+    }
+
+    // Names are indexed by trigram and length together: a name more than k
+    // characters longer or shorter than the query is more than k edits away,
+    // so a query only reads the lists of the 2k + 1 lengths around its own.
+    // Lengths from 255 up share the last class.
+    static uint32_t lengthClass(size_t length) { return static_cast<uint32_t>(std::min<size_t>(length, 255)); }
+    static uint32_t postingKey(uint32_t gram, uint32_t lengthClass) { return gram | (lengthClass << 24); }
+
+    size_t home(uint32_t key) const { return (key * 0x9E3779B1u) >> (32 - bucketBits); }
+
+    // Bucket holding `key`, or the empty bucket where it would go.
+    size_t probe(uint32_t key) const {
+        size_t mask = buckets.size() - 1;
+        size_t pos = home(key);
+        while (buckets[pos].list != EMPTY && buckets[pos].key != key) {
+            pos = (pos + 1) & mask;
+        }
+        return pos;
+    }
+
+    const std::vector<uint32_t>* findPostings(uint32_t key) const {
+        size_t pos = probe(key);
+        return buckets[pos].list == EMPTY ? nullptr : &postings[buckets[pos].list];
+    }
+
+    std::vector<uint32_t>& postingsFor(uint32_t key) {
+        size_t pos = probe(key);
+        if (buckets[pos].list != EMPTY) {
+            return postings[buckets[pos].list];
+        }
+        if ((postings.size() + 1) * 10 > buckets.size() * 7) {
+            std::vector<GramBucket> old = std::move(buckets);
+            buckets.assign(old.size() * 2, GramBucket{0, EMPTY});
+            ++bucketBits;
+            for (const GramBucket& bucket : old) {
+                if (bucket.list != EMPTY) {
+                    buckets[probe(bucket.key)] = bucket;
+                }
+            }
+            pos = probe(key);
+        }
+        buckets[pos] = GramBucket{key, static_cast<int32_t>(postings.size())};
+        postings.emplace_back();
+        return postings.back();
+    }
+
+    void index(uint32_t id, std::string_view name) {
+        std::string_view key = arena.intern(lowered(name));
+        if (names.size() <= id) {
+            names.resize(id + 1);
+            signatures.resize(id + 1);
+        }
+        names[id] = key;
+        uint32_t length = lengthClass(key.size());
+        forEachGram(key, [&](uint32_t gram) {
+            std::vector<uint32_t>& list = postingsFor(postingKey(gram, length));
+            // A trigram repeated within one name is posted once.
+            if (list.empty() || list.back() != id) {
+                list.push_back(id);
+            }
+            signatures[id].add(gram);
+        });
+        ++nameCount;
+    }
+
+    // Levenshtein distance between a and b, or bound + 1 once it is known to
+    // exceed `bound`. Only the diagonal band |i - j| <= bound of the table
+    // can stay within the bound, so only that band is computed.
+    unsigned boundedDistance(std::string_view a, std::string_view b, unsigned bound) {
+        if (a.size() > b.size()) {
+            std::swap(a, b);
+        }
+        if (b.size() - a.size() > bound) {
+            return bound + 1;
+        }
+        const unsigned over = bound + 1;
+        row.resize(a.size() + 1);
+        for (size_t i = 0; i <= a.size(); ++i) {
+            row[i] = std::min(static_cast<unsigned>(i), over);
+        }
+        for (size_t j = 1; j <= b.size(); ++j) {
+            size_t first = j > bound ? j - bound : 1;
+            size_t last = std::min(a.size(), j + bound);
+            unsigned diagonal = row[first - 1];
+            row[first - 1] = first == 1 ? std::min(static_cast<unsigned>(j), over) : over;
+            unsigned rowMin = row[first - 1];
+            for (size_t i = first; i <= last; ++i) {
+                unsigned above = row[i];
+                row[i] = std::min({above + 1, row[i - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0u : 1u), over});
+                diagonal = above;
+                rowMin = std::min(rowMin, row[i]);
+            }
+            if (rowMin > bound) {
+                return over;
+            }
+        }
+        return row[a.size()];
+    }
+
+public:
+    // Indexes one product name under `id`. Ids must be added in increasing
+    // order.
+    void add(uint32_t id, std::string_view name) {
+        index(id, name);
+        indexedUpTo = std::max(indexedUpTo, id + 1);
+    }
+
+    // Indexes every product `catalog` has added since the last refresh.
+    void refresh(const Catalog& catalog) {
+        uint32_t limit = catalog.idLimit();
+        for (uint32_t id = indexedUpTo; id < limit; ++id) {
+            if (const Product* product = catalog.findById(id)) {
+                index(id, product->getName());
+            }
+        }
+        indexedUpTo = std::max(indexedUpTo, limit);
+    }
+
+    size_t size() const { return nameCount; }
+
+    // Up to `limit` live products whose names are within maxEdits() of
+    // `query` (case-insensitive), closest first, ties by id.
+    template <typename IsLive>
+    std::vector<Match> closest(std::string_view query, size_t limit, IsLive isLive) {
+        std::string key = lowered(query);
+        unsigned edits = maxEdits(key.size());
+
+        std::vector<GramLists> grams;  // by trigram start
+        uint32_t shortest = lengthClass(key.size() - edits);
+        uint32_t longest = lengthClass(key.size() + edits);
+        Signature querySignature;
+        forEachGram(key, [&](uint32_t gram) {
+            GramLists lists;
+            for (uint32_t length = shortest; length <= longest; ++length) {
+                const std::vector<uint32_t>* list = findPostings(postingKey(gram, length));
+                if (list) {
+                    lists.lists[lists.count++] = list;
+                    lists.postings += list->size();
+                }
+            }
+            grams.push_back(lists);
+            querySignature.add(gram);
+        });
+
+        seen.resize(names.size());
+        touched.clear();
+        for (size_t start : cheapestDisjoint(grams, edits + 1)) {
+            for (size_t i = 0; i < grams[start].count; ++i) {
+                for (uint32_t id : *grams[start].lists[i]) {
+                    if (!seen[id]) {
+                        seen[id] = 1;
+                        touched.push_back(id);
+                    }
+                }
+            }
+        }
+
+        std::vector<Match> matches;
+        const size_t prefetchDistance = 16;
+        for (size_t i = 0; i < touched.size(); ++i) {
+            // Candidates are scattered over the id space; keep several
+            // signature loads in flight instead of waiting on each miss.
+            if (i + prefetchDistance < touched.size()) {
+                __builtin_prefetch(&signatures[touched[i + prefetchDistance]]);
+            }
+            uint32_t id = touched[i];
+            seen[id] = 0;
+            if (signatures[id].missingFrom(querySignature) > 3 * edits || !isLive(id)) {
+                continue;
+            }
+            unsigned distance = boundedDistance(key, names[id], edits);
+            if (distance <= edits) {
+                matches.push_back(Match{id, distance});
+            }
+        }
+
+        std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+            return a.distance != b.distance ? a.distance < b.distance : a.id < b.id;
+        });
+        if (matches.size() > limit) {
+            matches.resize(limit);
+        }
+        return matches;
+    }
+};
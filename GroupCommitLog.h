@@ -0,0 +1,104 @@
+#pragma once
+
+#include "FileUtil.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// GroupCommitLog Class
+// Append-only file where every append() returns only once its bytes are on
+// disk, but concurrent appends share one write + fdatasync. The first
+// caller to find no flush in progress becomes the leader: it takes every
+// record queued so far, writes them as one block and syncs, while later
+// callers queue behind it and are released together when their batch is
+// durable. Throughput under contention is then bounded by fsyncs per
+// second times batch size instead of fsyncs per second alone.
+//
+// After a failed write or sync the log is poisoned: the records of that
+// batch and every later append report failure.
+class GroupCommitLog {
+    int fd = -1;
+    std::mutex mutex;
+    std::condition_variable flushed;
+    std::string pending;        // records queued for the next batch
+    uint64_t appendedSeq = 0;   // sequence number of the last queued record
+    uint64_t durableSeq = 0;    // every record up to here has been flushed
+    uint64_t failedFrom = UINT64_MAX;  // first record of the first failed batch
+    bool flushing = false;
+    uint64_t batches = 0;
+
+public:
+    GroupCommitLog() = default;
+    ~GroupCommitLog() { close(); }
+
+    GroupCommitLog(const GroupCommitLog&) = delete;
+    GroupCommitLog& operator=(const GroupCommitLog&) = delete;
+
+    // Opens (creating if needed) `filename` for appending.
+    bool open(const std::string& filename) {
+        close();
+        fd = ::open(filename.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+        failedFrom = UINT64_MAX;
+        return fd >= 0;
+    }
+
+    void close() {
+        std::unique_lock<std::mutex> lock(mutex);
+        flushed.wait(lock, [this] { return !flushing; });
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    bool isOpen() const { return fd >= 0; }
+
+    // Number of write + sync rounds so far (appends / batches = batch size).
+    uint64_t batchCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return batches;
+    }
+
+    // Queues `record` and blocks until it is durable. Returns false if the
+    // log is closed or the batch containing the record failed to flush.
+    bool append(std::string_view record) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (fd < 0 || failedFrom != UINT64_MAX) {
+            return false;
+        }
+        pending.append(record);
+        uint64_t mySeq = ++appendedSeq;
+
+        while (durableSeq < mySeq) {
+            if (flushing) {
+                flushed.wait(lock);
+                continue;
+            }
+            // Become the leader for everything queued so far.
+            flushing = true;
+            std::string batch;
+            batch.swap(pending);
+            uint64_t batchFirst = durableSeq + 1;
+            uint64_t batchLast = appendedSeq;
+            lock.unlock();
+
+            bool ok = writeAll(fd, batch.data(), batch.size()) && ::fdatasync(fd) == 0;
+
+            lock.lock();
+            flushing = false;
+            ++batches;
+            if (!ok && failedFrom == UINT64_MAX) {
+                failedFrom = batchFirst;
+            }
+            durableSeq = batchLast;
+            flushed.notify_all();
+        }
+        return mySeq < failedFrom;
+    }
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Money.h"
+#include "SmallVector.h"
+
+#include <cstdint>
+
+// One product in a cart or order, referenced by its stable catalog id.
+struct LineItem {
+    uint32_t productId;
+    uint32_t quantity;
+    Money unitPrice;  // price at checkout; 0 while the item is still in a cart
+};
+
+// Most carts hold a handful of distinct products, so the first 8 line
+// items live inline and a cart or order only allocates beyond that.
+using LineItems = SmallVector<LineItem, 8>;
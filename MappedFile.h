@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// MappedFile Class
+// Read-only memory mapping of a whole file. The contents are exposed as a
+// string_view so parsers can tokenize in place without copying. Pass
+// sequential = false for files that are read randomly (e.g. an index).
+class MappedFile {
+    const char* data = nullptr;
+    size_t length = 0;
+    bool opened = false;
+
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filename, bool sequential = true) {
+        open(filename, sequential);
+    }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& filename, bool sequential = true) {
+        close();
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                length = 0;
+                return false;
+            }
+            madvise(mapped, length, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+            data = static_cast<const char*>(mapped);
+        }
+        ::close(fd);  // the mapping stays valid after the descriptor is closed
+        opened = true;
+        return true;
+    }
+
+    void close() {
+        if (data != nullptr) {
+            munmap(const_cast<char*>(data), length);
+        }
+        data = nullptr;
+        length = 0;
+        opened = false;
+    }
+
+    bool isOpen() const { return opened; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(data, length); }
+};
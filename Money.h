@@ -0,0 +1,133 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Money Class
+// An amount in integer cents. Sums and quantity multiples are exact, so an
+// order total is the same whatever order its lines are added in (and a
+// parallel reduction gives bit-identical results), and integer columns
+// vectorize without rounding concerns. Amounts are parsed from and
+// formatted to decimal text directly ("12.5" -> 1250 cents -> "12.50"),
+// never through a binary double.
+class Money {
+    int64_t cents = 0;
+
+    constexpr explicit Money(int64_t amountCents) : cents(amountCents) {}
+
+public:
+    // Longest text format() writes: a sign, 17 whole digits, the point and
+    // two decimals.
+    static constexpr size_t MAX_CHARS = 21;
+
+    constexpr Money() = default;
+
+    static constexpr Money fromCents(int64_t amountCents) { return Money(amountCents); }
+
+    // Nearest cent, for amounts that only exist as a double.
+    static Money fromDouble(double amount) { return Money(std::llround(amount * 100.0)); }
+
+    constexpr int64_t inCents() const { return cents; }
+    double toDouble() const { return static_cast<double>(cents) / 100.0; }
+
+    // Parses a plain decimal amount: an optional sign, digits, and an
+    // optional fraction ("12", "12.5", "-0.99", ".5", "1000.000000").
+    // Digits past the cent round half away from zero. Returns false, and
+    // leaves `out` alone, on anything else (exponents, stray characters,
+    // overflow).
+    static bool parse(std::string_view text, Money& out) {
+        bool negative = !text.empty() && text.front() == '-';
+        if (negative || (!text.empty() && text.front() == '+')) {
+            text.remove_prefix(1);
+        }
+        size_t point = text.find('.');
+        std::string_view whole = text.substr(0, point);
+        std::string_view fraction = point == std::string_view::npos ? std::string_view() : text.substr(point + 1);
+        if (whole.empty() && fraction.empty()) {
+            return false;
+        }
+
+        constexpr int64_t MAX_WHOLE = (INT64_MAX - 100) / 100;
+        int64_t units = 0;
+        for (char c : whole) {
+            if (c < '0' || c > '9' || units > (MAX_WHOLE - (c - '0')) / 10) {
+                return false;
+            }
+            units = units * 10 + (c - '0');
+        }
+        int64_t fractionCents = 0;
+        for (size_t i = 0; i < fraction.size(); ++i) {
+            char c = fraction[i];
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            if (i < 2) {
+                fractionCents = fractionCents * 10 + (c - '0');
+            } else if (i == 2 && c >= '5') {
+                ++fractionCents;  // may carry into the whole part, which is fine
+            }
+        }
+        if (fraction.size() == 1) {
+            fractionCents *= 10;
+        }
+        int64_t amount = units * 100 + fractionCents;
+        out = Money(negative ? -amount : amount);
+        return true;
+    }
+
+    // Writes the amount as "[-]units.cc" into [first, last), which must
+    // hold MAX_CHARS characters, and returns one past the last written.
+    char* format(char* first, char* last) const {
+        uint64_t magnitude = cents < 0 ? 0 - static_cast<uint64_t>(cents) : static_cast<uint64_t>(cents);
+        if (cents < 0) {
+            *first++ = '-';
+        }
+        first = std::to_chars(first, last, magnitude / 100).ptr;
+        unsigned fraction = static_cast<unsigned>(magnitude % 100);
+        *first++ = '.';
+        *first++ = static_cast<char>('0' + fraction / 10);
+        *first++ = static_cast<char>('0' + fraction % 10);
+        return first;
+    }
+
+    std::string toString() const {
+        char text[MAX_CHARS];
+        return std::string(text, format(text, text + MAX_CHARS));
+    }
+
+    constexpr Money& operator+=(Money other) {
+        cents += other.cents;
+        return *this;
+    }
+    constexpr Money& operator-=(Money other) {
+        cents -= other.cents;
+        return *this;
+    }
+    friend constexpr Money operator+(Money a, Money b) { return Money(a.cents + b.cents); }
+    friend constexpr Money operator-(Money a, Money b) { return Money(a.cents - b.cents); }
+    friend constexpr Money operator*(Money price, int64_t quantity) { return Money(price.cents * quantity); }
+    friend constexpr Money operator*(int64_t quantity, Money price) { return Money(price.cents * quantity); }
+    friend constexpr auto operator<=>(Money a, Money b) = default;
+
+    friend std::ostream& operator<<(std::ostream& out, Money amount) {
+        char text[MAX_CHARS];
+        return out.write(text, amount.format(text, text + MAX_CHARS) - text);
+    }
+
+    // Reads one whitespace-delimited token and parses it as above; sets
+    // failbit if it is not an amount.
+    friend std::istream& operator>>(std::istream& in, Money& amount) {
+        std::string token;
+        if (in >> token && !parse(token, amount)) {
+            in.setstate(std::ios::failbit);
+        }
+        return in;
+    }
+};
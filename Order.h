@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Catalog.h"
+#include "LineItem.h"
+
+#include <iostream>
+#include <string>
+#include <utility>
+
+// Order Class
+class Order {
+    std::string customerName;
+    LineItems items;
+
+public:
+    Order(std::string cname, LineItems&& litems)
+        : customerName(std::move(cname)), items(std::move(litems)) {}
+
+    const std::string& getCustomerName() const { return customerName; }
+    const LineItems& getItems() const { return items; }
+
+    // Exact: the sum of integer cents does not depend on line order.
+    Money total() const {
+        Money sum;
+        for (const LineItem& item : items) {
+            sum += item.unitPrice * item.quantity;
+        }
+        return sum;
+    }
+
+    void displayOrder(const Catalog& catalog, std::ostream& out = std::cout) const {
+        out << "Order for " << customerName << ":\n";
+        for (const LineItem& item : items) {
+            const Product* product = catalog.findById(item.productId);
+            out << "- ";
+            if (product) {
+                out << product->getName();
+            } else {
+                out << "(removed product #" << item.productId << ")";
+            }
+            out << " x" << item.quantity << " @ $" << item.unitPrice << "\n";
+        }
+        out << "Total: $" << total() << "\n";
+    }
+};
@@ -0,0 +1,311 @@
+#pragma once
+
+#include "LineItem.h"
+#include "Money.h"
+#include "Order.h"
+#include "OrderLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// TopK Class
+// The `capacity` keys with the highest counts, in a min-heap with an index
+// from key to heap slot. offer() moves a tracked key in place, and admits
+// an untracked one when it beats the smallest tracked count. Offering
+// every change keeps the heap exact while counts only grow; a count that
+// drops (revenue from a negative price) keeps the heap valid, but a key
+// evicted earlier is not brought back.
+template <typename Key, typename Hash = std::hash<Key>>
+class TopK {
+public:
+    struct Entry {
+        Key key;
+        int64_t count;
+    };
+
+    explicit TopK(size_t maxKeys) : capacity(maxKeys) {}
+
+    // Records that `key` now has `count`. O(log capacity).
+    void offer(const Key& key, int64_t count) {
+        auto found = slots.find(key);
+        if (found != slots.end()) {
+            size_t slot = found->second;
+            bool decreased = count < heap[slot].count;
+            heap[slot].count = count;
+            if (decreased) {
+                siftUp(slot);
+            } else {
+                siftDown(slot);
+            }
+            return;
+        }
+        if (heap.size() < capacity) {
+            heap.push_back(Entry{key, count});
+            slots.emplace(key, heap.size() - 1);
+            siftUp(heap.size() - 1);
+        } else if (capacity > 0 && count > heap.front().count) {
+            slots.erase(heap.front().key);
+            heap.front() = Entry{key, count};
+            slots.emplace(key, 0);
+            siftDown(0);
+        }
+    }
+
+    // Up to k entries, highest count first (ties by insertion order are
+    // not preserved).
+    std::vector<Entry> top(size_t k) const {
+        std::vector<Entry> result = heap;
+        k = std::min(k, result.size());
+        std::partial_sort(result.begin(), result.begin() + static_cast<ptrdiff_t>(k), result.end(),
+                          [](const Entry& a, const Entry& b) { return a.count > b.count; });
+        result.resize(k);
+        return result;
+    }
+
+    void clear() {
+        heap.clear();
+        slots.clear();
+    }
+
+private:
+    size_t capacity;
+    std::vector<Entry> heap;  // min-heap on count
+    std::unordered_map<Key, size_t, Hash> slots;
+
+    void swapSlots(size_t a, size_t b) {
+        std::swap(heap[a], heap[b]);
+        slots[heap[a].key] = a;
+        slots[heap[b].key] = b;
+    }
+
+    void siftUp(size_t i) {
+        while (i > 0 && heap[i].count < heap[(i - 1) / 2].count) {
+            swapSlots(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+    }
+
+    void siftDown(size_t i) {
+        while (true) {
+            size_t smallest = i;
+            for (size_t child = 2 * i + 1; child <= 2 * i + 2 && child < heap.size(); ++child) {
+                if (heap[child].count < heap[smallest].count) {
+                    smallest = child;
+                }
+            }
+            if (smallest == i) {
+                return;
+            }
+            swapSlots(i, smallest);
+            i = smallest;
+        }
+    }
+};
+
+// CountMinSketch Class
+// Approximate counts for an unbounded key set in fixed memory (DEPTH rows
+// of WIDTH counters, 64 KB). An estimate never undercounts and, with
+// conservative update, overcounts by at most about e / WIDTH (0.13%) of
+// the total weight added, with probability 1 - e^-DEPTH.
+class CountMinSketch {
+public:
+    static constexpr size_t DEPTH = 4;
+    static constexpr size_t WIDTH = 2048;  // power of two
+
+    CountMinSketch() : counters(DEPTH * WIDTH, 0) {}
+
+    // Adds `weight` to `key` and returns its new estimate. Each row is only
+    // raised as far as that estimate (conservative update), which keeps
+    // collisions from inflating counts needlessly.
+    int64_t add(uint64_t key, int64_t weight) {
+        size_t cells[DEPTH];
+        int64_t estimate = std::numeric_limits<int64_t>::max();
+        for (size_t row = 0; row < DEPTH; ++row) {
+            cells[row] = row * WIDTH + column(key, row);
+            estimate = std::min(estimate, counters[cells[row]]);
+        }
+        estimate += weight;
+        for (size_t cell : cells) {
+            counters[cell] = std::max(counters[cell], estimate);
+        }
+        return estimate;
+    }
+
+    int64_t estimate(uint64_t key) const {
+        int64_t estimate = std::numeric_limits<int64_t>::max();
+        for (size_t row = 0; row < DEPTH; ++row) {
+            estimate = std::min(estimate, counters[row * WIDTH + column(key, row)]);
+        }
+        return estimate;
+    }
+
+    void clear() { std::fill(counters.begin(), counters.end(), 0); }
+
+private:
+    std::vector<int64_t> counters;
+
+    // An independent hash per row (a seeded 64-bit finalizer).
+    static size_t column(uint64_t key, size_t row) {
+        uint64_t h = key * 0x9E3779B97F4A7C15ull + (row + 1) * 0x632BE59BD9B4E019ull;
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 32;
+        return static_cast<size_t>(h & (WIDTH - 1));
+    }
+};
+
+// OrderAnalytics Class
+// Sales aggregates kept up to date as orders are placed, so reports never
+// re-scan the order history:
+//   - per product (by catalog id): units sold, revenue and orders
+//   - per customer: orders and total spend
+//   - the top products by units and by revenue, and the top customers by
+//     spend, each an exact TopK of TOP_CAPACITY
+//   - today's top sellers by units: a CountMinSketch for the current UTC
+//     day plus a TopK of its heaviest hitters. The sketch is a fixed 64 KB
+//     cleared at midnight, rather than a per-product table that would need
+//     clearing (and would grow with the catalog).
+// Queries cost O(1) or O(TOP_CAPACITY) whatever the number of orders.
+// All members lock, so checkouts on many server sessions can record
+// concurrently with admin reports.
+class OrderAnalytics {
+public:
+    static constexpr size_t TOP_CAPACITY = 100;
+
+    struct ProductTotals {
+        uint64_t units = 0;
+        Money revenue;
+        uint64_t orders = 0;
+    };
+
+    struct CustomerTotals {
+        uint64_t orders = 0;
+        Money spend;
+    };
+
+    // A product or customer with its count: units, or cents for revenue
+    // and spend rankings.
+    using RankedProduct = TopK<uint32_t>::Entry;
+    using RankedCustomer = TopK<std::string>::Entry;
+
+    // Days since the Unix epoch, UTC.
+    static int64_t currentDay() {
+        using namespace std::chrono;
+        return duration_cast<days>(system_clock::now().time_since_epoch()).count();
+    }
+
+    // Adds an order placed on `day` (by default today).
+    void record(const Order& order, int64_t day = currentDay()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (day != today) {
+            todaySketch.clear();
+            topToday.clear();
+            today = day;
+        }
+        for (const LineItem& item : order.getItems()) {
+            topToday.offer(item.productId, todaySketch.add(item.productId, item.quantity));
+        }
+        addToTotals(order);
+    }
+
+    // Adds an order from before this process started (replayed from the
+    // order log). Its date is unknown, so it counts towards the all-time
+    // totals but not today's top sellers. Replay resolves products by name,
+    // so the catalog must be loaded before the log is opened; line items
+    // whose product is not in it (OrderLog::UNKNOWN_PRODUCT) count towards
+    // spend and revenue only.
+    void restore(const Order& order) {
+        std::lock_guard<std::mutex> lock(mutex);
+        addToTotals(order);
+    }
+
+    ProductTotals productTotals(uint32_t productId) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return productId < products.size() ? products[productId] : ProductTotals();
+    }
+
+    CustomerTotals customerTotals(const std::string& customerName) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = customers.find(customerName);
+        return found == customers.end() ? CustomerTotals() : found->second;
+    }
+
+    uint64_t orderCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return orders;
+    }
+
+    Money totalRevenue() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return revenue;
+    }
+
+    // Rankings, highest first, at most min(k, TOP_CAPACITY) long.
+    std::vector<RankedProduct> topProductsByUnits(size_t k) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return topUnits.top(k);
+    }
+
+    std::vector<RankedProduct> topProductsByRevenue(size_t k) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return topRevenue.top(k);
+    }
+
+    std::vector<RankedCustomer> topCustomers(size_t k) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return topSpend.top(k);
+    }
+
+    // Units are sketch estimates: never low, and high by at most ~0.13% of
+    // the day's units. Empty once `day` has moved past the last order.
+    std::vector<RankedProduct> topSellersToday(size_t k, int64_t day = currentDay()) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return day == today ? topToday.top(k) : std::vector<RankedProduct>();
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::vector<ProductTotals> products;  // indexed by product id
+    std::unordered_map<std::string, CustomerTotals> customers;
+    uint64_t orders = 0;
+    Money revenue;
+    TopK<uint32_t> topUnits{TOP_CAPACITY};
+    TopK<uint32_t> topRevenue{TOP_CAPACITY};
+    TopK<std::string> topSpend{TOP_CAPACITY};
+    int64_t today = std::numeric_limits<int64_t>::min();
+    CountMinSketch todaySketch;
+    TopK<uint32_t> topToday{TOP_CAPACITY};
+
+    void addToTotals(const Order& order) {
+        for (const LineItem& item : order.getItems()) {
+            if (item.productId == OrderLog::UNKNOWN_PRODUCT) {
+                continue;
+            }
+            if (item.productId >= products.size()) {
+                products.resize(std::max<size_t>(item.productId + 1, products.size() * 2));
+            }
+            ProductTotals& totals = products[item.productId];
+            totals.units += item.quantity;
+            totals.revenue += item.unitPrice * item.quantity;
+            ++totals.orders;
+            topUnits.offer(item.productId, static_cast<int64_t>(totals.units));
+            topRevenue.offer(item.productId, totals.revenue.inCents());
+        }
+        Money spent = order.total();
+        CustomerTotals& customer = customers[order.getCustomerName()];
+        ++customer.orders;
+        customer.spend += spent;
+        topSpend.offer(order.getCustomerName(), customer.spend.inCents());
+        ++orders;
+        revenue += spent;
+    }
+};
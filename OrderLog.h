@@ -0,0 +1,290 @@
+#pragma once
+
+#include "Catalog.h"
+#include "FileUtil.h"
+#include "GroupCommitLog.h"
+#include "LineItem.h"
+#include "MappedFile.h"
+#include "Order.h"
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// OrderLog Class
+// Write-ahead log of placed orders, appended on every checkout and
+// replayed at startup. Layout (native byte order):
+//
+//   Header   magic "ECORDLOG", format version, byte-order mark
+//   Record   uint32 payload length, uint32 CRC-32C of the payload, payload
+//   Payload  uint32 name length, customer name, uint32 item count, then
+//            per item: uint32 quantity, int64 unit price in cents, uint32
+//            name length, product name
+//
+// Version 1 logs stored the unit price as a double; they are still
+// replayed (rounded to the cent) and appended to in that format.
+//
+// Products are recorded by name, since catalog ids only live as long as
+// the process. Appends go through a GroupCommitLog, so an order is durable
+// when append() returns, and concurrent checkouts share one fdatasync.
+// A torn or corrupt tail (a crash mid-write) ends the replay there and is
+// cut off so new records follow the last intact one.
+class OrderLog {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 2;
+    static constexpr uint32_t DOUBLE_PRICES_VERSION = 1;
+
+    struct ReplayStats {
+        size_t ordersReplayed = 0;
+        size_t unknownProducts = 0;  // line items whose product is not in the catalog
+        uint64_t bytesDiscarded = 0;  // torn or corrupt tail that was cut off
+    };
+
+private:
+    static constexpr char MAGIC[8] = {'E', 'C', 'O', 'R', 'D', 'L', 'O', 'G'};
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static constexpr uint32_t MAX_RECORD_BYTES = 64 * 1024 * 1024;
+
+    struct Header {
+        char magic[8];
+        uint32_t formatVersion;
+        uint32_t byteOrderMark;
+    };
+
+    std::string filename;
+    GroupCommitLog log;
+    uint32_t fileVersion = FORMAT_VERSION;  // format of the open file
+
+    static constexpr std::array<uint32_t, 256> makeCrcTable() {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));  // Castagnoli polynomial
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    static uint32_t crc32c(std::string_view data) {
+        static constexpr std::array<uint32_t, 256> table = makeCrcTable();
+        uint32_t crc = 0xFFFFFFFFu;
+        for (unsigned char c : data) {
+            crc = table[(crc ^ c) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    template <typename T>
+    static void put(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    static void putString(std::string& out, std::string_view text) {
+        put(out, static_cast<uint32_t>(text.size()));
+        out.append(text);
+    }
+
+    // Bounds-checked reader over one payload.
+    class Cursor {
+        std::string_view data;
+
+    public:
+        explicit Cursor(std::string_view payload) : data(payload) {}
+
+        template <typename T>
+        bool get(T& value) {
+            if (data.size() < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, data.data(), sizeof(T));
+            data.remove_prefix(sizeof(T));
+            return true;
+        }
+
+        bool getString(std::string_view& text) {
+            uint32_t length;
+            if (!get(length) || data.size() < length) {
+                return false;
+            }
+            text = data.substr(0, length);
+            data.remove_prefix(length);
+            return true;
+        }
+
+        bool done() const { return data.empty(); }
+    };
+
+    static bool getPrice(Cursor& cursor, uint32_t version, Money& price) {
+        if (version == DOUBLE_PRICES_VERSION) {
+            double amount;
+            if (!cursor.get(amount)) {
+                return false;
+            }
+            price = Money::fromDouble(amount);
+            return true;
+        }
+        int64_t cents;
+        if (!cursor.get(cents)) {
+            return false;
+        }
+        price = Money::fromCents(cents);
+        return true;
+    }
+
+    // Decodes one payload into an order; ids are looked up by name.
+    static bool decode(std::string_view payload, uint32_t version, const Catalog& catalog,
+                       std::vector<Order>& orders, ReplayStats& stats) {
+        Cursor cursor(payload);
+        std::string_view customer;
+        uint32_t itemCount;
+        if (!cursor.getString(customer) || !cursor.get(itemCount)) {
+            return false;
+        }
+        LineItems items;
+        for (uint32_t i = 0; i < itemCount; ++i) {
+            LineItem item;
+            std::string_view name;
+            if (!cursor.get(item.quantity) || !getPrice(cursor, version, item.unitPrice) || !cursor.getString(name)) {
+                return false;
+            }
+            const Product* product = catalog.find(name);
+            item.productId = product ? product->getId() : UNKNOWN_PRODUCT;
+            stats.unknownProducts += product == nullptr;
+            items.push_back(item);
+        }
+        if (!cursor.done()) {
+            return false;
+        }
+        orders.emplace_back(std::string(customer), std::move(items));
+        return true;
+    }
+
+    bool writeHeader() {
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.formatVersion = FORMAT_VERSION;
+        header.byteOrderMark = BYTE_ORDER_MARK;
+        int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = writeAll(fd, &header, sizeof(header)) && ::fsync(fd) == 0;
+        return (::close(fd) == 0) && ok;
+    }
+
+public:
+    // Product id given to replayed line items whose product is not in the
+    // catalog passed to open().
+    static constexpr uint32_t UNKNOWN_PRODUCT = UINT32_MAX;
+
+    explicit OrderLog(std::string logFile) : filename(std::move(logFile)) {}
+
+    const std::string& getFilename() const { return filename; }
+    bool isOpen() const { return log.isOpen(); }
+    uint64_t batchCount() { return log.batchCount(); }
+
+    // Replays every intact record into `orders`, cuts off a torn tail and
+    // opens the log for appending. A missing or empty file starts a new
+    // log; a file that is not an order log is left alone and fails.
+    bool open(const Catalog& catalog, std::vector<Order>& orders, ReplayStats& stats) {
+        stats = ReplayStats();
+        struct stat info;
+        if (::stat(filename.c_str(), &info) != 0 ? errno == ENOENT : info.st_size == 0) {
+            fileVersion = FORMAT_VERSION;
+            return writeHeader() && log.open(filename);
+        }
+        MappedFile file;
+        if (!file.open(filename)) {
+            return false;
+        }
+
+        std::string_view data = file.view();
+        Header header;
+        if (data.size() < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            (header.formatVersion != FORMAT_VERSION && header.formatVersion != DOUBLE_PRICES_VERSION) ||
+            header.byteOrderMark != BYTE_ORDER_MARK) {
+            return false;
+        }
+        fileVersion = header.formatVersion;
+
+        size_t pos = sizeof(header);
+        while (data.size() - pos >= 2 * sizeof(uint32_t)) {
+            uint32_t length;
+            uint32_t checksum;
+            std::memcpy(&length, data.data() + pos, sizeof(length));
+            std::memcpy(&checksum, data.data() + pos + sizeof(length), sizeof(checksum));
+            size_t payloadStart = pos + 2 * sizeof(uint32_t);
+            if (length > MAX_RECORD_BYTES || length > data.size() - payloadStart) {
+                break;
+            }
+            std::string_view payload = data.substr(payloadStart, length);
+            if (crc32c(payload) != checksum || !decode(payload, fileVersion, catalog, orders, stats)) {
+                break;
+            }
+            ++stats.ordersReplayed;
+            pos = payloadStart + length;
+        }
+
+        stats.bytesDiscarded = data.size() - pos;
+        file.close();
+        if (stats.bytesDiscarded > 0 && ::truncate(filename.c_str(), static_cast<off_t>(pos)) != 0) {
+            return false;
+        }
+        return log.open(filename);
+    }
+
+    // Appends `order` and returns once it is on disk. `catalog` (a Catalog
+    // or a ShardedCatalog::Reader) supplies the product names.
+    template <typename CatalogView>
+    bool append(const Order& order, const CatalogView& catalog) {
+        std::string record;
+        encode(order, catalog, record);
+        return log.append(record);
+    }
+
+    // Adds the record for `order` to the end of `records`, for appendBatch().
+    // Encoding is read-only, so batches can be encoded on worker threads.
+    template <typename CatalogView>
+    void encode(const Order& order, const CatalogView& catalog, std::string& records) const {
+        size_t start = records.size();
+        records.append(2 * sizeof(uint32_t), '\0');
+        putString(records, order.getCustomerName());
+        put(records, static_cast<uint32_t>(order.getItems().size()));
+        for (const LineItem& item : order.getItems()) {
+            const auto* product = catalog.findById(item.productId);
+            put(records, item.quantity);
+            if (fileVersion == DOUBLE_PRICES_VERSION) {
+                put(records, item.unitPrice.toDouble());
+            } else {
+                put(records, item.unitPrice.inCents());
+            }
+            putString(records, product ? std::string_view(product->getName()) : std::string_view());
+        }
+
+        std::string_view payload = std::string_view(records).substr(start + 2 * sizeof(uint32_t));
+        uint32_t length = static_cast<uint32_t>(payload.size());
+        uint32_t checksum = crc32c(payload);
+        std::memcpy(records.data() + start, &length, sizeof(length));
+        std::memcpy(records.data() + start + sizeof(length), &checksum, sizeof(checksum));
+    }
+
+    // Appends records built by encode() with one write and one sync;
+    // returns once all of them are on disk.
+    bool appendBatch(std::string_view records) { return log.append(records); }
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Money.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+// Product Class
+// Stock is an atomic so checkouts on many threads can reserve units of the
+// same product with compare-and-swap instead of a lock. Copies take a
+// snapshot of the current stock level.
+//
+// The name is a view, not an owned string: a Catalog interns the names of
+// the products it holds into its own arena, so millions of products cost
+// no per-name allocation. A Product built outside a catalog views the
+// caller's string, which must outlive it; building one from a temporary
+// std::string does not compile for that reason.
+class Product {
+    std::string_view name;
+    Money price;
+    std::atomic<int> stock;
+    uint32_t id = 0;  // assigned by the Catalog on insert, never reused
+
+    friend class Catalog;
+
+public:
+    Product(std::string_view pname = {}, Money pprice = {}, int pstock = 0)
+        : name(pname), price(pprice), stock(pstock) {}
+    Product(const char* pname, Money pprice = {}, int pstock = 0)
+        : Product(std::string_view(pname), pprice, pstock) {}
+    Product(std::string&& pname, Money pprice = {}, int pstock = 0) = delete;  // would dangle
+
+    Product(const Product& other) noexcept
+        : name(other.name), price(other.price), stock(other.getStock()), id(other.id) {}
+
+    Product& operator=(const Product& other) noexcept {
+        name = other.name;
+        price = other.price;
+        stock.store(other.getStock(), std::memory_order_relaxed);
+        id = other.id;
+        return *this;
+    }
+
+    uint32_t getId() const { return id; }
+    std::string_view getName() const { return name; }
+    Money getPrice() const { return price; }
+    int getStock() const { return stock.load(std::memory_order_relaxed); }
+
+    void setPrice(Money pprice) { price = pprice; }
+    void setStock(int pstock) { stock.store(pstock, std::memory_order_relaxed); }
+
+    void displayProduct(std::ostream& out = std::cout) const {
+        out << "Product: " << name << ", Price: $" << price
+            << ", Stock: " << getStock() << std::endl;
+    }
+
+    // Takes `quantity` units if that many are available. Lock-free: the
+    // compare-and-swap retries only when another thread changed the stock
+    // in between, and the level never goes below zero.
+    bool reduceStock(int quantity = 1) { return takeStock(stock, quantity); }
+
+    // The compare-and-swap loop behind reduceStock, for stock levels kept
+    // outside a Product (see ShardedCatalog).
+    static bool takeStock(std::atomic<int>& level, int quantity) {
+        int current = level.load(std::memory_order_relaxed);
+        do {
+            if (current < quantity) {
+                return false;
+            }
+        } while (!level.compare_exchange_weak(current, current - quantity,
+                                              std::memory_order_acq_rel, std::memory_order_relaxed));
+        return true;
+    }
+
+    // Moves a stock level by `delta` without losing units reserved
+    // concurrently, clamped to 0..INT32_MAX: a feed lowering stock below
+    // what has already sold leaves none, not a negative level.
+    static void shiftStock(std::atomic<int>& level, int64_t delta) {
+        int current = level.load(std::memory_order_relaxed);
+        int next;
+        do {
+            next = static_cast<int>(std::clamp<int64_t>(current + delta, 0, INT32_MAX));
+        } while (!level.compare_exchange_weak(current, next, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed));
+    }
+
+    // Gives back units taken by reduceStock (e.g. when a checkout fails).
+    void restoreStock(int quantity) {
+        stock.fetch_add(quantity, std::memory_order_acq_rel);
+    }
+
+    // Getter for saving products to CSV
+    std::string toCSV() const {
+        return std::string(name) + "," + price.toString() + "," + std::to_string(getStock());
+    }
+};
@@ -0,0 +1,288 @@
+#pragma once
+
+#include "Catalog.h"
+#include "SmallVector.h"
+#include "StringArena.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ProductSearch Class
+// Search over product names, keyed by catalog id. It holds two indexes:
+//
+//   - Prefix (autocomplete): lower-cased names in a few sorted arrays
+//     ("runs"), each answered with a binary search and a short forward
+//     walk. New names are inserted into a small first run; a run that
+//     outgrows its capacity (8x the previous run's) is merged into the next
+//     one. Adding a product then costs a small insert plus a few amortized
+//     entry copies per run, and a query binary-searches O(log n) flat
+//     arrays (five for 5M names).
+//   - Keywords: an inverted index from each lower-cased alphanumeric token
+//     to the ids whose names contain it. Ids are handed out in increasing
+//     order, so posting lists are sorted by construction and a multi-word
+//     query is a merge-free intersection, starting from the rarest token.
+//
+// The index only grows. refresh() picks up the ids a Catalog has handed out
+// since the last call, the same catch-up-on-use approach ColumnarCatalog
+// takes. Queries skip ids the caller reports as no longer live (erased
+// products).
+class ProductSearch {
+    struct Entry {
+        std::string_view key;  // lower-cased name, in the arena
+        uint32_t id;
+
+        bool operator<(const Entry& other) const { return key < other.key; }
+    };
+
+    struct TokenBucket {
+        uint32_t hash;
+        int32_t token;  // index into tokens/postings, or EMPTY
+    };
+    static constexpr int32_t EMPTY = -1;
+
+    static constexpr size_t FIRST_RUN_ENTRIES = 4096;
+    static constexpr unsigned RUN_GROWTH_BITS = 3;  // each run holds 8x the previous one
+
+    StringArena arena;
+    std::vector<std::vector<Entry>> runs = std::vector<std::vector<Entry>>(1);  // each sorted by key
+    // Token dictionary, open addressing as in Catalog. Most tokens (model
+    // numbers, rare words) name one or two products, so short posting lists
+    // stay inline.
+    using Postings = SmallVector<uint32_t, 2>;
+    std::vector<TokenBucket> tokenBuckets = std::vector<TokenBucket>(16, TokenBucket{0, EMPTY});
+    std::vector<std::string_view> tokens;
+    std::vector<Postings> postings;
+    uint32_t indexedUpTo = 0;  // catalog ids below this have been indexed
+    size_t nameCount = 0;
+    std::string scratch;
+
+    static char lower(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+    static bool isWordChar(char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    const std::string& lowered(std::string_view text) {
+        scratch.resize(text.size());
+        std::transform(text.begin(), text.end(), scratch.begin(), lower);
+        return scratch;
+    }
+
+    // Calls fn(token) for every lower-cased token of `key` (already lower-cased).
+    template <typename Fn>
+    static void forEachToken(std::string_view key, Fn fn) {
+        size_t pos = 0;
+        while (pos < key.size()) {
+            while (pos < key.size() && !isWordChar(key[pos])) {
+                ++pos;
+            }
+            size_t start = pos;
+            while (pos < key.size() && isWordChar(key[pos])) {
+                ++pos;
+            }
+            if (pos > start) {
+                fn(key.substr(start, pos - start));
+            }
+        }
+    }
+
+    // Bucket holding `token`, or the empty bucket where it would go.
+    size_t probeToken(std::string_view token, uint32_t hash) const {
+        size_t mask = tokenBuckets.size() - 1;
+        size_t pos = hash & mask;
+        while (tokenBuckets[pos].token != EMPTY) {
+            if (tokenBuckets[pos].hash == hash && tokens[tokenBuckets[pos].token] == token) {
+                return pos;
+            }
+            pos = (pos + 1) & mask;
+        }
+        return pos;
+    }
+
+    const Postings* findPostings(std::string_view token) const {
+        size_t pos = probeToken(token, Catalog::hashName(token));
+        return tokenBuckets[pos].token == EMPTY ? nullptr : &postings[tokenBuckets[pos].token];
+    }
+
+    Postings& postingsFor(std::string_view token) {
+        uint32_t hash = Catalog::hashName(token);
+        size_t pos = probeToken(token, hash);
+        if (tokenBuckets[pos].token != EMPTY) {
+            return postings[tokenBuckets[pos].token];
+        }
+        if ((tokens.size() + 1) * 10 > tokenBuckets.size() * 7) {
+            std::vector<TokenBucket> old = std::move(tokenBuckets);
+            tokenBuckets.assign(old.size() * 2, TokenBucket{0, EMPTY});
+            for (const TokenBucket& bucket : old) {
+                if (bucket.token != EMPTY) {
+                    size_t slot = bucket.hash & (tokenBuckets.size() - 1);
+                    while (tokenBuckets[slot].token != EMPTY) {
+                        slot = (slot + 1) & (tokenBuckets.size() - 1);
+                    }
+                    tokenBuckets[slot] = bucket;
+                }
+            }
+            pos = probeToken(token, hash);
+        }
+        tokenBuckets[pos] = TokenBucket{hash, static_cast<int32_t>(tokens.size())};
+        tokens.push_back(arena.intern(token));
+        postings.emplace_back();
+        return postings.back();
+    }
+
+    void indexTokens(std::string_view key, uint32_t id) {
+        forEachToken(key, [&](std::string_view token) {
+            Postings& list = postingsFor(token);
+            // A token repeated within one name is posted once.
+            if (list.empty() || list.back() != id) {
+                list.push_back(id);
+            }
+        });
+    }
+
+    static void mergeInto(std::vector<Entry>& target, std::vector<Entry>& source) {
+        std::vector<Entry> merged;
+        merged.reserve(target.size() + source.size());
+        std::merge(target.begin(), target.end(), source.begin(), source.end(), std::back_inserter(merged));
+        target.swap(merged);
+        source.clear();
+    }
+
+    static size_t runCapacity(size_t level) { return FIRST_RUN_ENTRIES << (RUN_GROWTH_BITS * level); }
+
+    // Merges every over-capacity run into the next one.
+    void compact() {
+        for (size_t level = 0; level < runs.size(); ++level) {
+            if (runs[level].size() > runCapacity(level)) {
+                if (level + 1 == runs.size()) {
+                    runs.emplace_back();
+                }
+                mergeInto(runs[level + 1], runs[level]);
+            }
+        }
+    }
+
+    // Appends up to `limit` live entries of `run` that start with `prefix`.
+    template <typename IsLive>
+    static void collectPrefix(const std::vector<Entry>& run, std::string_view prefix, size_t limit,
+                              IsLive& isLive, std::vector<Entry>& out) {
+        auto it = std::lower_bound(run.begin(), run.end(), Entry{prefix, 0});
+        size_t found = 0;
+        for (; it != run.end() && found < limit && it->key.substr(0, prefix.size()) == prefix; ++it) {
+            if (isLive(it->id)) {
+                out.push_back(*it);
+                ++found;
+            }
+        }
+    }
+
+public:
+    // Indexes one product name under `id`. Ids must be added in increasing
+    // order.
+    void add(uint32_t id, std::string_view name) {
+        Entry entry{arena.intern(lowered(name)), id};
+        std::vector<Entry>& first = runs[0];
+        first.insert(std::upper_bound(first.begin(), first.end(), entry), entry);
+        indexTokens(entry.key, id);
+        indexedUpTo = std::max(indexedUpTo, id + 1);
+        ++nameCount;
+        compact();
+    }
+
+    // Indexes every product `catalog` has added since the last refresh.
+    // New names are sorted once as a batch, so a bulk upload costs one sort
+    // and one merge rather than one sorted insert per product.
+    void refresh(const Catalog& catalog) {
+        uint32_t limit = catalog.idLimit();
+        if (indexedUpTo >= limit) {
+            return;
+        }
+        std::vector<Entry> batch;
+        batch.reserve(limit - indexedUpTo);
+        for (uint32_t id = indexedUpTo; id < limit; ++id) {
+            if (const Product* product = catalog.findById(id)) {
+                Entry entry{arena.intern(lowered(product->getName())), id};
+                batch.push_back(entry);
+                indexTokens(entry.key, id);
+            }
+        }
+        indexedUpTo = limit;
+        nameCount += batch.size();
+        std::sort(batch.begin(), batch.end());
+        size_t level = 0;
+        while (runCapacity(level) < batch.size()) {
+            ++level;
+        }
+        if (level >= runs.size()) {
+            runs.resize(level + 1);
+        }
+        mergeInto(runs[level], batch);
+        compact();
+    }
+
+    size_t size() const { return nameCount; }
+
+    // Ids of up to `limit` live products whose names start with `prefix`
+    // (case-insensitive), in name order.
+    template <typename IsLive>
+    std::vector<uint32_t> prefixSearch(std::string_view prefix, size_t limit, IsLive isLive) {
+        std::string key = lowered(prefix);
+        std::vector<Entry> matches;
+        for (const std::vector<Entry>& run : runs) {
+            collectPrefix(run, key, limit, isLive, matches);
+        }
+        std::sort(matches.begin(), matches.end());
+
+        std::vector<uint32_t> ids;
+        for (size_t i = 0; i < matches.size() && i < limit; ++i) {
+            ids.push_back(matches[i].id);
+        }
+        return ids;
+    }
+
+    // Ids of up to `limit` live products whose names contain every word of
+    // `query` (case-insensitive, whole words), oldest first.
+    template <typename IsLive>
+    std::vector<uint32_t> keywordSearch(std::string_view query, size_t limit, IsLive isLive) {
+        std::vector<const Postings*> lists;
+        bool missing = false;
+        forEachToken(lowered(query), [&](std::string_view token) {
+            const Postings* list = findPostings(token);
+            if (list == nullptr) {
+                missing = true;
+            } else {
+                lists.push_back(list);
+            }
+        });
+        std::vector<uint32_t> ids;
+        if (missing || lists.empty()) {
+            return ids;
+        }
+        std::sort(lists.begin(), lists.end(),
+                  [](const auto* a, const auto* b) { return a->size() < b->size(); });
+
+        // Walk the rarest list; advance a cursor into each other list with a
+        // binary search from where it last stopped.
+        std::vector<const uint32_t*> cursors;
+        for (const auto* list : lists) {
+            cursors.push_back(list->begin());
+        }
+        for (uint32_t id : *lists[0]) {
+            bool inAll = true;
+            for (size_t i = 1; i < lists.size() && inAll; ++i) {
+                cursors[i] = std::lower_bound(cursors[i], lists[i]->end(), id);
+                inAll = cursors[i] != lists[i]->end() && *cursors[i] == id;
+            }
+            if (inAll && isLive(id)) {
+                ids.push_back(id);
+                if (ids.size() == limit) {
+                    break;
+                }
+            }
+        }
+        return ids;
+    }
+};
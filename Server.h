@@ -0,0 +1,616 @@
+#pragma once
+
+#include "Catalog.h"
+#include "CatalogWatcher.h"
+#include "ShardedCatalog.h"
+#include "CredentialStore.h"
+#include "Order.h"
+#include "OrderAnalytics.h"
+#include "OrderLog.h"
+#include "ThreadPool.h"
+#include "Users.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Server Class
+// Multi-session front end for the same Admin/Customer operations as the
+// interactive menu, over a local TCP port or Unix socket.
+//
+// Protocol: one request per line, "COMMAND arg1,arg2,...". Every response
+// is "OK <bytes>\n" or "ERR <bytes>\n" followed by exactly <bytes> bytes of
+// message text (what the menu would have printed). Commands:
+//
+//   PING                         REGISTER user,password
+//   LOGIN user,password          ADMIN user,password
+//   BROWSE [offset[,limit]]      NEXT [limit]
+//   ADD product name,quantity    CHECKOUT
+//   ADDPRODUCT name,price,stock  UPLOAD [prune]  SAVE          (admin)
+//   STATS  SALES                                               (admin)
+//   LOGOUT                       QUIT
+//
+// One thread runs an epoll loop that accepts connections and reads
+// requests; complete lines are handed to a worker pool. Each connection
+// keeps its own Session (logged-in customer/admin and cart), and its
+// requests run one at a time and in order, so session state needs no
+// locking. The catalog is a ShardedCatalog: browse, cart and checkout
+// read through an epoch-pinned Reader and never block, while admin writes
+// publish new versions alongside them. With watchProductCSV, a
+// CatalogWatcher reloads the CSV file whenever it changes on disk. Admin
+// UPLOADs and the watcher sync through one shared CsvSync, so a change to
+// the file is applied once however many of them pick it up.
+class Server {
+public:
+    struct Config {
+        std::string endpoint = "9090";  // TCP port on 127.0.0.1, or a Unix socket path
+        unsigned workers = 0;           // 0 = hardware_concurrency
+        std::string productCSVFile = "products.csv";
+        std::string adminUsername = "admin";
+        std::string adminPassword = "1234";
+        bool watchProductCSV = false;  // reload productCSVFile when it changes
+    };
+
+private:
+    // Per-connection login state, cart and message buffer.
+    class Session {
+        Customer customer{"", ""};
+        Admin admin{"", ""};
+        bool customerLoggedIn = false;
+        bool adminLoggedIn = false;
+        std::ostringstream out;
+
+        static std::string frame(bool ok, const std::string& body) {
+            std::string response = ok ? "OK " : "ERR ";
+            response += std::to_string(body.size());
+            response += '\n';
+            response += body;
+            return response;
+        }
+
+        // Splits "a,b,c" into at most `count` fields; the last keeps any
+        // remaining commas (passwords may contain them).
+        static std::vector<std::string> splitArgs(std::string_view args, size_t count) {
+            std::vector<std::string> fields;
+            while (fields.size() + 1 < count) {
+                size_t comma = args.find(',');
+                if (comma == std::string_view::npos) {
+                    break;
+                }
+                fields.emplace_back(args.substr(0, comma));
+                args.remove_prefix(comma + 1);
+            }
+            fields.emplace_back(args);
+            return fields;
+        }
+
+        template <typename Number>
+        static bool parseNumber(const std::string& text, Number& value) {
+            const char* end = text.data() + text.size();
+            auto result = std::from_chars(text.data(), end, value);
+            return !text.empty() && result.ec == std::errc() && result.ptr == end;
+        }
+
+        std::string takeOutput() {
+            std::string body = out.str();
+            out.str(std::string());
+            return body;
+        }
+
+    public:
+        // Runs one request line and returns the framed response. Sets
+        // `quit` when the client asked to close the connection.
+        std::string handle(std::string_view line, Server& server, bool& quit) {
+            size_t space = line.find(' ');
+            std::string_view command = line.substr(0, space);
+            std::string_view args = space == std::string_view::npos ? std::string_view() : line.substr(space + 1);
+            bool ok = true;
+
+            if (command == "PING") {
+                out << "PONG\n";
+            } else if (command == "QUIT") {
+                out << "Bye.\n";
+                quit = true;
+            } else if (command == "LOGOUT") {
+                customerLoggedIn = false;
+                adminLoggedIn = false;
+                out << "Logged out.\n";
+            } else if (command == "REGISTER" || command == "LOGIN") {
+                std::vector<std::string> fields = splitArgs(args, 2);
+                if (fields.size() != 2) {
+                    return frame(false, "Usage: " + std::string(command) + " user,password\n");
+                }
+                customer = Customer(fields[0], fields[1]);
+                customer.setOutput(out);
+                if (command == "REGISTER") {
+                    ok = customer.registerUser(server.credentials);
+                } else {
+                    ok = customer.verifyCredentials(server.credentials);
+                    if (ok) {
+                        customer.login();
+                    } else {
+                        out << "Invalid Customer credentials.\n";
+                    }
+                }
+                customerLoggedIn = ok;
+            } else if (command == "ADMIN") {
+                std::vector<std::string> fields = splitArgs(args, 2);
+                ok = fields.size() == 2 && fields[0] == server.config.adminUsername &&
+                     fields[1] == server.config.adminPassword;
+                if (ok) {
+                    admin = Admin(fields[0], fields[1]);
+                    admin.setOutput(out);
+                    admin.shareProductSync(server.productSync);
+                    admin.login();
+                } else {
+                    out << "Invalid Admin credentials.\n";
+                }
+                adminLoggedIn = ok;
+            } else if (command == "BROWSE" || command == "NEXT" || command == "ADD" || command == "CHECKOUT") {
+                if (!customerLoggedIn) {
+                    return frame(false, "Please log in as a customer first.\n");
+                }
+                if (command == "BROWSE" || command == "NEXT") {
+                    std::vector<std::string> fields = splitArgs(args, 2);
+                    size_t offset = 0;
+                    size_t limit = CatalogPager::DEFAULT_PAGE_SIZE;
+                    bool valid = command == "BROWSE"
+                        ? (args.empty() || (parseNumber(fields[0], offset) &&
+                                            (fields.size() == 1 || parseNumber(fields[1], limit))))
+                        : (args.empty() || parseNumber(fields[0], limit));
+                    if (!valid) {
+                        return frame(false, "Usage: BROWSE [offset[,limit]] or NEXT [limit]\n");
+                    }
+                    if (command == "BROWSE") {
+                        customer.browseProducts(server.catalog.read(), offset, limit);
+                    } else {
+                        customer.browseNextPage(server.catalog.read(), limit);
+                    }
+                } else if (command == "ADD") {
+                    std::vector<std::string> fields = splitArgs(args, 2);
+                    uint32_t quantity = 1;
+                    if (fields.size() == 2 && !parseNumber(fields[1], quantity)) {
+                        return frame(false, "Usage: ADD product name,quantity\n");
+                    }
+                    ok = customer.addToCart(server.catalog.read(), fields[0], quantity);
+                } else {
+                    std::vector<Order> placed;
+                    {
+                        ShardedCatalog::Reader view = server.catalog.read();
+                        customer.checkout(view, placed, server.orderLog, server.analytics);
+                    }
+                    ok = !placed.empty();
+                    if (ok) {
+                        std::lock_guard<std::mutex> lock(server.ordersMutex);
+                        server.orders.push_back(std::move(placed.back()));
+                    }
+                }
+            } else if (command == "STATS") {
+                if (!adminLoggedIn) {
+                    return frame(false, "Please log in as admin first.\n");
+                }
+                server.reportStats(out);
+            } else if (command == "SALES") {
+                if (!adminLoggedIn) {
+                    return frame(false, "Please log in as admin first.\n");
+                }
+                if (!server.analytics) {
+                    return frame(false, "Sales analytics are off.\n");
+                }
+                admin.showSalesReport(server.catalog.read(), *server.analytics);
+            } else if (command == "ADDPRODUCT" || command == "UPLOAD" || command == "SAVE") {
+                if (!adminLoggedIn) {
+                    return frame(false, "Please log in as admin first.\n");
+                }
+                if (command == "ADDPRODUCT") {
+                    std::vector<std::string> fields = splitArgs(args, 3);
+                    Money price;
+                    int stock = 0;
+                    if (fields.size() != 3 || !Money::parse(fields[1], price) || !parseNumber(fields[2], stock)) {
+                        return frame(false, "Usage: ADDPRODUCT name,price,stock\n");
+                    }
+                    admin.addProduct(server.catalog, Product(fields[0], price, stock));
+                } else if (command == "UPLOAD") {
+                    // "UPLOAD prune" also removes products missing from the file.
+                    admin.uploadProductsFromCSV(server.catalog, server.config.productCSVFile, args == "prune");
+                } else {
+                    admin.saveProductsToCSV(server.catalog, server.config.productCSVFile);
+                }
+            } else {
+                return frame(false, "Unknown command: " + std::string(command) + "\n");
+            }
+            return frame(ok, takeOutput());
+        }
+    };
+
+    struct Connection {
+        int fd;
+        std::string inBuffer;  // event loop thread only
+
+        std::mutex mutex;  // guards everything below
+        std::deque<std::string> pending;
+        std::string outBuffer;
+        size_t outSent = 0;
+        bool busy = false;       // a worker is draining `pending`
+        bool wantWrite = false;  // EPOLLOUT registered
+        bool closing = false;    // shut down once outBuffer drains
+        bool closed = false;     // removed from the event loop
+
+        Session session;  // only touched by the worker holding `busy`
+
+        explicit Connection(int socketFd) : fd(socketFd) {}
+        ~Connection() { ::close(fd); }
+    };
+
+    static constexpr size_t MAX_REQUEST_BYTES = 64 * 1024;
+
+    Config config;
+    ShardedCatalog& catalog;
+    CredentialStore& credentials;
+    std::vector<Order>& orders;
+    std::mutex ordersMutex;
+    OrderLog* orderLog;  // optional; when set, checkouts are durable before they are confirmed
+    OrderAnalytics* analytics;  // optional; when set, every placed order is added to it
+    std::shared_ptr<CsvSync> productSync;  // shared by every admin session and the watcher
+
+    std::unique_ptr<CatalogWatcher> watcher;  // set when config.watchProductCSV
+
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;
+    std::unordered_map<int, std::shared_ptr<Connection>> connections;  // event loop thread only
+
+    static std::atomic<int>& signalWakeFd() {
+        static std::atomic<int> fd{-1};
+        return fd;
+    }
+
+    static void onSignal(int) {
+        int fd = signalWakeFd().load();
+        if (fd >= 0) {
+            uint64_t one = 1;
+            [[maybe_unused]] ssize_t ignored = ::write(fd, &one, sizeof(one));
+        }
+    }
+
+    bool listenOn(const std::string& endpoint) {
+        bool isPort = !endpoint.empty() && endpoint.find_first_not_of("0123456789") == std::string::npos;
+        if (isPort) {
+            uint16_t port;
+            if (!parsePort(endpoint, port)) {
+                return false;
+            }
+            listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (listenFd < 0) {
+                return false;
+            }
+            int on = 1;
+            setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(port);
+            if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                return false;
+            }
+        } else {
+            listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            sockaddr_un address{};
+            if (listenFd < 0 || endpoint.size() >= sizeof(address.sun_path)) {
+                return false;
+            }
+            address.sun_family = AF_UNIX;
+            std::memcpy(address.sun_path, endpoint.c_str(), endpoint.size() + 1);
+            ::unlink(endpoint.c_str());
+            if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                return false;
+            }
+        }
+        return ::listen(listenFd, SOMAXCONN) == 0;
+    }
+
+    void watch(int fd, uint32_t events, int op) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, op, fd, &event);
+    }
+
+    void acceptAll() {
+        while (true) {
+            int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return;  // EAGAIN (drained) or a transient error
+            }
+            int on = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));  // fails harmlessly on Unix sockets
+            connections.emplace(fd, std::make_shared<Connection>(fd));
+            watch(fd, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_ADD);
+        }
+    }
+
+    void closeConnection(int fd) {
+        auto it = connections.find(fd);
+        if (it == connections.end()) {
+            return;
+        }
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        {
+            std::lock_guard<std::mutex> lock(it->second->mutex);
+            it->second->closed = true;
+        }
+        connections.erase(it);  // the fd closes when the last worker lets go
+    }
+
+    // Sends as much of the output buffer as the socket takes. Called with
+    // the connection's mutex held, from a worker or the event loop.
+    void flush(Connection& conn) {
+        while (conn.outSent < conn.outBuffer.size()) {
+            ssize_t sent = ::send(conn.fd, conn.outBuffer.data() + conn.outSent,
+                                  conn.outBuffer.size() - conn.outSent, MSG_NOSIGNAL);
+            if (sent > 0) {
+                conn.outSent += static_cast<size_t>(sent);
+                continue;
+            }
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (!conn.wantWrite) {
+                    conn.wantWrite = true;
+                    watch(conn.fd, EPOLLIN | EPOLLOUT | EPOLLRDHUP, EPOLL_CTL_MOD);
+                }
+                return;
+            }
+            conn.closing = true;  // peer gone; the loop will see the hangup
+            ::shutdown(conn.fd, SHUT_RDWR);
+            return;
+        }
+        conn.outBuffer.clear();
+        conn.outSent = 0;
+        if (conn.wantWrite) {
+            conn.wantWrite = false;
+            watch(conn.fd, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_MOD);
+        }
+        if (conn.closing) {
+            ::shutdown(conn.fd, SHUT_RDWR);
+        }
+    }
+
+    // Worker task: runs the connection's queued requests in order.
+    void drain(const std::shared_ptr<Connection>& conn) {
+        while (true) {
+            std::string line;
+            {
+                std::lock_guard<std::mutex> lock(conn->mutex);
+                if (conn->pending.empty() || conn->closed || conn->closing) {
+                    conn->busy = false;
+                    return;
+                }
+                line = std::move(conn->pending.front());
+                conn->pending.pop_front();
+            }
+
+            bool quit = false;
+            std::string response = conn->session.handle(line, *this, quit);
+
+            std::lock_guard<std::mutex> lock(conn->mutex);
+            if (conn->closed) {
+                continue;
+            }
+            conn->outBuffer += response;
+            conn->closing = conn->closing || quit;
+            flush(*conn);
+        }
+    }
+
+    void readFrom(const std::shared_ptr<Connection>& conn) {
+        char chunk[16 * 1024];
+        bool hangup = false;
+        while (true) {
+            ssize_t received = ::read(conn->fd, chunk, sizeof(chunk));
+            if (received > 0) {
+                conn->inBuffer.append(chunk, static_cast<size_t>(received));
+                continue;
+            }
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            hangup = received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+            break;
+        }
+
+        std::vector<std::string> lines;
+        size_t start = 0;
+        size_t newline;
+        while ((newline = conn->inBuffer.find('\n', start)) != std::string::npos) {
+            size_t end = newline;
+            if (end > start && conn->inBuffer[end - 1] == '\r') {
+                --end;
+            }
+            lines.emplace_back(conn->inBuffer, start, end - start);
+            start = newline + 1;
+        }
+        conn->inBuffer.erase(0, start);
+        if (conn->inBuffer.size() > MAX_REQUEST_BYTES) {
+            hangup = true;
+        }
+
+        bool dispatch = false;
+        if (!lines.empty()) {
+            std::lock_guard<std::mutex> lock(conn->mutex);
+            for (std::string& line : lines) {
+                conn->pending.push_back(std::move(line));
+            }
+            if (!conn->busy) {
+                conn->busy = true;
+                dispatch = true;
+            }
+        }
+        if (dispatch) {
+            pool.submit([this, conn] { drain(conn); });
+        }
+        if (hangup) {
+            closeConnection(conn->fd);
+        }
+    }
+
+    ThreadPool pool;
+
+    void reportStats(std::ostream& out) const {
+        if (!watcher) {
+            out << "File watcher is off.\n";
+            return;
+        }
+        CatalogWatcher::Metrics metrics = watcher->metrics();
+        out << "Catalog reloads: " << metrics.reloads << " (" << metrics.unchanged << " unchanged, "
+            << metrics.failures << " failed)\n";
+        if (metrics.reloads > 0) {
+            out << "Reload latency: last " << metrics.lastLatencyMs << " ms, mean "
+                << metrics.totalLatencyMs / metrics.reloads << " ms, max " << metrics.maxLatencyMs
+                << " ms (last sync " << metrics.lastSyncMs << " ms)\n";
+        }
+    }
+
+public:
+    Server(Config serverConfig, ShardedCatalog& sharedCatalog, CredentialStore& credentialStore,
+           std::vector<Order>& orderList, OrderLog* log = nullptr, OrderAnalytics* salesAnalytics = nullptr,
+           std::shared_ptr<CsvSync> csvSync = nullptr)
+        : config(std::move(serverConfig)), catalog(sharedCatalog), credentials(credentialStore),
+          orders(orderList), orderLog(log), analytics(salesAnalytics),
+          productSync(csvSync ? std::move(csvSync) : std::make_shared<CsvSync>()),
+          pool(config.workers ? config.workers : std::max(2u, std::thread::hardware_concurrency())) {}
+
+    ~Server() {
+        if (listenFd >= 0) {
+            ::close(listenFd);
+        }
+        if (epollFd >= 0) {
+            ::close(epollFd);
+        }
+        if (wakeFd >= 0) {
+            // Unregister only our own fd; on failure the CAS would copy the
+            // global into its first argument, so that must not be wakeFd.
+            int expected = wakeFd;
+            signalWakeFd().compare_exchange_strong(expected, -1);
+            ::close(wakeFd);
+        }
+    }
+
+    // Parses a TCP port (1-65535) given as decimal digits; false for
+    // anything else, including values too large for an unsigned.
+    static bool parsePort(std::string_view text, uint16_t& port) {
+        unsigned value;
+        const char* end = text.data() + text.size();
+        auto result = std::from_chars(text.data(), end, value);
+        if (text.empty() || result.ec != std::errc() || result.ptr != end || value == 0 || value > 65535) {
+            return false;
+        }
+        port = static_cast<uint16_t>(value);
+        return true;
+    }
+
+    // Binds the endpoint and sets up the event loop. Returns false if it
+    // cannot be bound, including a numeric endpoint outside 1-65535.
+    bool start() {
+        if (!listenOn(config.endpoint)) {
+            return false;
+        }
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollFd < 0 || wakeFd < 0) {
+            return false;
+        }
+        watch(listenFd, EPOLLIN, EPOLL_CTL_ADD);
+        watch(wakeFd, EPOLLIN, EPOLL_CTL_ADD);
+        if (config.watchProductCSV) {
+            watcher = std::make_unique<CatalogWatcher>(catalog, config.productCSVFile, productSync);
+            if (!watcher->start()) {
+                std::cout << "Failed to watch " << config.productCSVFile << "; use UPLOAD to reload it.\n";
+                watcher.reset();
+            }
+        }
+        return true;
+    }
+
+    // Makes SIGINT/SIGTERM stop this server's run() loop.
+    void stopOnSignals() {
+        signalWakeFd().store(wakeFd);
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+    }
+
+    // Safe to call from any thread.
+    void stop() {
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+    }
+
+    const std::string& endpoint() const { return config.endpoint; }
+
+    // Serves connections until stop() is called.
+    void run() {
+        epoll_event events[128];
+        bool running = true;
+        while (running) {
+            int ready = epoll_wait(epollFd, events, 128, -1);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            for (int i = 0; i < ready; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    acceptAll();
+                    continue;
+                }
+                if (fd == wakeFd) {
+                    running = false;
+                    continue;
+                }
+                auto it = connections.find(fd);
+                if (it == connections.end()) {
+                    continue;
+                }
+                std::shared_ptr<Connection> conn = it->second;
+                if (events[i].events & EPOLLOUT) {
+                    std::lock_guard<std::mutex> lock(conn->mutex);
+                    flush(*conn);
+                }
+                if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                    readFrom(conn);
+                }
+            }
+        }
+        while (!connections.empty()) {
+            closeConnection(connections.begin()->first);
+        }
+    }
+};
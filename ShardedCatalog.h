@@ -0,0 +1,547 @@
+#pragma once
+
+#include "Catalog.h"
+#include "EpochDomain.h"
+#include "LineItem.h"
+#include "Product.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// One product as seen through a ShardedCatalog. Name and price never change
+// once published (an update publishes a new item with the same id); the
+// stock level is a live counter shared by every item with that id.
+class CatalogItem {
+    std::string name;
+    Money price;
+    uint32_t id;
+    std::atomic<int>* stock;
+
+public:
+    CatalogItem(std::string iname, Money iprice, uint32_t iid, std::atomic<int>* istock)
+        : name(std::move(iname)), price(iprice), id(iid), stock(istock) {}
+
+    uint32_t getId() const { return id; }
+    const std::string& getName() const { return name; }
+    Money getPrice() const { return price; }
+    int getStock() const { return stock->load(std::memory_order_relaxed); }
+
+    void displayProduct(std::ostream& out = std::cout) const {
+        out << "Product: " << name << ", Price: $" << price
+            << ", Stock: " << getStock() << std::endl;
+    }
+};
+
+// ShardedCatalog Class
+// Catalog for many concurrent sessions, where browsing and cart lookups far
+// outnumber admin writes. Products are split into SHARD_COUNT shards by name
+// hash, each an immutable open-addressing index. A version (one pointer per
+// shard) is published through a single atomic pointer:
+//
+//   - Readers take a Reader, which pins the current version through an
+//     EpochDomain. They never lock and never wait for a writer.
+//   - Writers copy only the shards they touch, then swap in the new
+//     version. A bulk publish() (e.g. a CSV upload) becomes visible all at
+//     once. Replaced shards and items are freed after the readers that
+//     might see them are done.
+//
+// Stock levels live outside the versions, in one atomic cell per product id,
+// so checkouts reserve stock with the same lock-free compare-and-swap as
+// Catalog and no reservation is lost when a new version is published.
+class ShardedCatalog {
+public:
+    static constexpr unsigned SHARD_BITS = 6;
+    static constexpr size_t SHARD_COUNT = size_t(1) << SHARD_BITS;
+
+    struct PublishStats {
+        size_t inserted = 0;
+        size_t updated = 0;
+        size_t unchanged = 0;
+        size_t erased = 0;
+    };
+
+    // A price update for an existing product whose stock moves by
+    // `stockDelta` instead of being overwritten (see Catalog::adjust).
+    struct Adjustment {
+        std::string_view name;
+        Money price;
+        int64_t stockDelta;
+    };
+
+private:
+    static constexpr int32_t EMPTY = -1;
+
+    struct Bucket {
+        uint32_t hash;
+        int32_t slot;  // index into items, or EMPTY
+    };
+
+    // Same layout and probing as Catalog, over pointers to shared items.
+    struct Shard {
+        std::vector<const CatalogItem*> items;
+        std::vector<Bucket> buckets = std::vector<Bucket>(16, Bucket{0, EMPTY});
+        size_t mask = 15;
+
+        size_t probe(std::string_view name, uint32_t hash) const {
+            size_t pos = hash & mask;
+            while (buckets[pos].slot != EMPTY) {
+                const Bucket& bucket = buckets[pos];
+                if (bucket.hash == hash && items[bucket.slot]->getName() == name) {
+                    return pos;
+                }
+                pos = (pos + 1) & mask;
+            }
+            return pos;
+        }
+
+        void rehash(size_t bucketCount) {
+            std::vector<Bucket> old = std::move(buckets);
+            buckets.assign(bucketCount, Bucket{0, EMPTY});
+            mask = bucketCount - 1;
+            for (const Bucket& bucket : old) {
+                if (bucket.slot != EMPTY) {
+                    size_t pos = bucket.hash & mask;
+                    while (buckets[pos].slot != EMPTY) {
+                        pos = (pos + 1) & mask;
+                    }
+                    buckets[pos] = bucket;
+                }
+            }
+        }
+
+        // `name` must not be present yet.
+        void insert(const CatalogItem* item, uint32_t hash) {
+            if ((items.size() + 1) * 10 > buckets.size() * 7) {
+                rehash(buckets.size() * 2);
+            }
+            buckets[probe(item->getName(), hash)] = Bucket{hash, static_cast<int32_t>(items.size())};
+            items.push_back(item);
+        }
+
+        // Backward-shift deletion plus swap-remove, as in Catalog::erase.
+        void erase(size_t hole) {
+            size_t slot = buckets[hole].slot;
+            size_t pos = hole;
+            while (true) {
+                pos = (pos + 1) & mask;
+                if (buckets[pos].slot == EMPTY) {
+                    break;
+                }
+                size_t home = buckets[pos].hash & mask;
+                bool homeInRange = (hole <= pos) ? (hole < home && home <= pos)
+                                                 : (hole < home || home <= pos);
+                if (!homeInRange) {
+                    buckets[hole] = buckets[pos];
+                    hole = pos;
+                }
+            }
+            buckets[hole].slot = EMPTY;
+
+            size_t last = items.size() - 1;
+            if (slot != last) {
+                size_t moved = Catalog::hashName(items[last]->getName()) & mask;
+                while (buckets[moved].slot != static_cast<int32_t>(last)) {
+                    moved = (moved + 1) & mask;
+                }
+                buckets[moved].slot = static_cast<int32_t>(slot);
+                items[slot] = items[last];
+            }
+            items.pop_back();
+        }
+    };
+
+    struct Version {
+        const Shard* shards[SHARD_COUNT];
+        size_t size;
+    };
+
+    // Per-id stock level plus the id's current item (nullptr once erased).
+    // Cells are allocated in chunks that never move.
+    struct Cell {
+        std::atomic<int> stock{0};
+        std::atomic<const CatalogItem*> item{nullptr};
+    };
+    static constexpr size_t CELL_CHUNK_BITS = 16;
+    static constexpr size_t CELLS_PER_CHUNK = size_t(1) << CELL_CHUNK_BITS;
+    static constexpr size_t MAX_CHUNKS = size_t(1) << 14;  // 2^30 product ids
+
+    mutable EpochDomain epochs;
+    std::atomic<const Version*> current;
+    std::unique_ptr<std::atomic<Cell*>[]> chunks;
+    mutable std::mutex writeMutex;  // serializes writers
+    uint32_t nextId = 0;    // guarded by writeMutex
+
+    static size_t shardOf(uint32_t hash) { return hash >> (32 - SHARD_BITS); }
+
+    Cell* cellOf(uint32_t id) const {
+        size_t chunk = id >> CELL_CHUNK_BITS;
+        if (chunk >= MAX_CHUNKS) {
+            return nullptr;
+        }
+        Cell* cells = chunks[chunk].load(std::memory_order_acquire);
+        return cells ? &cells[id & (CELLS_PER_CHUNK - 1)] : nullptr;
+    }
+
+    // Writer side: the cell for a new id, allocating its chunk if needed.
+    Cell* claimCell(uint32_t id) {
+        size_t chunk = id >> CELL_CHUNK_BITS;
+        if (!chunks[chunk].load(std::memory_order_relaxed)) {
+            chunks[chunk].store(new Cell[CELLS_PER_CHUNK], std::memory_order_release);
+        }
+        return cellOf(id);
+    }
+
+public:
+    // Epoch-pinned, read-only view of one published version. Keep it for
+    // the length of one operation (a browse, a checkout); the version it
+    // sees cannot be freed while it lives.
+    class Reader {
+        const ShardedCatalog* catalog;
+        EpochDomain::Guard guard;
+        const Version* version;
+
+        void releaseFirst(const LineItems& items, size_t count) const {
+            for (size_t i = 0; i < count; ++i) {
+                if (Cell* cell = catalog->cellOf(items[i].productId)) {
+                    cell->stock.fetch_add(static_cast<int>(items[i].quantity), std::memory_order_acq_rel);
+                }
+            }
+        }
+
+    public:
+        class const_iterator {
+            const Version* version;
+            size_t shard;
+            size_t index;
+
+            void skipEmptyShards() {
+                while (shard < SHARD_COUNT && index >= version->shards[shard]->items.size()) {
+                    ++shard;
+                    index = 0;
+                }
+            }
+
+        public:
+            const_iterator(const Version* v, size_t s, size_t i = 0) : version(v), shard(s), index(i) {
+                skipEmptyShards();
+            }
+
+            const CatalogItem& operator*() const { return *version->shards[shard]->items[index]; }
+            const CatalogItem* operator->() const { return version->shards[shard]->items[index]; }
+            const_iterator& operator++() {
+                ++index;
+                skipEmptyShards();
+                return *this;
+            }
+            bool operator==(const const_iterator& other) const {
+                return shard == other.shard && index == other.index;
+            }
+            bool operator!=(const const_iterator& other) const { return !(*this == other); }
+        };
+
+        explicit Reader(const ShardedCatalog& owner)
+            : catalog(&owner), guard(owner.epochs), version(owner.current.load()) {}
+
+        size_t size() const { return version->size; }
+        bool empty() const { return version->size == 0; }
+
+        // Iterates shard by shard, so the order is by name hash rather than
+        // insertion order.
+        const_iterator begin() const { return const_iterator(version, 0); }
+        const_iterator end() const { return const_iterator(version, SHARD_COUNT); }
+
+        // Iterator to the product at `position` in iteration order, found by
+        // skipping whole shards.
+        const_iterator at(size_t position) const {
+            size_t shard = 0;
+            while (shard < SHARD_COUNT && position >= version->shards[shard]->items.size()) {
+                position -= version->shards[shard]->items.size();
+                ++shard;
+            }
+            return const_iterator(version, shard, shard < SHARD_COUNT ? position : 0);
+        }
+
+        const CatalogItem* find(std::string_view name) const { return find(name, Catalog::hashName(name)); }
+
+        // Same with a precomputed Catalog::hashName(name).
+        const CatalogItem* find(std::string_view name, uint32_t hash) const {
+            const Shard& shard = *version->shards[shardOf(hash)];
+            size_t pos = shard.probe(name, hash);
+            return shard.buckets[pos].slot == EMPTY ? nullptr : shard.items[shard.buckets[pos].slot];
+        }
+
+        // Latest published item for `id` (possibly newer than this view's
+        // version), or nullptr if the product was erased.
+        const CatalogItem* findById(uint32_t id) const {
+            Cell* cell = catalog->cellOf(id);
+            return cell ? cell->item.load() : nullptr;
+        }
+
+        // Same contract as Catalog::reserveStock: all line items or none.
+        long reserveStock(const LineItems& items) const {
+            for (size_t i = 0; i < items.size(); ++i) {
+                Cell* cell = catalog->cellOf(items[i].productId);
+                if (!cell || !cell->item.load() || items[i].quantity > INT32_MAX ||
+                    !Product::takeStock(cell->stock, static_cast<int>(items[i].quantity))) {
+                    releaseFirst(items, i);
+                    return static_cast<long>(i);
+                }
+            }
+            return -1;
+        }
+
+        void releaseStock(const LineItems& items) const { releaseFirst(items, items.size()); }
+    };
+
+    ShardedCatalog() : chunks(new std::atomic<Cell*>[MAX_CHUNKS]()) {
+        Version* initial = new Version;
+        for (const Shard*& shard : initial->shards) {
+            shard = new Shard;
+        }
+        initial->size = 0;
+        current.store(initial);
+    }
+
+    ShardedCatalog(const ShardedCatalog&) = delete;
+    ShardedCatalog& operator=(const ShardedCatalog&) = delete;
+
+    // No Reader may outlive the catalog.
+    ~ShardedCatalog() {
+        const Version* version = current.load();
+        for (const Shard* shard : version->shards) {
+            for (const CatalogItem* item : shard->items) {
+                delete item;
+            }
+            delete shard;
+        }
+        delete version;
+        for (size_t chunk = 0; chunk < MAX_CHUNKS; ++chunk) {
+            delete[] chunks[chunk].load();
+        }
+    }
+
+    Reader read() const { return Reader(*this); }
+
+    size_t size() const { return read().size(); }
+
+    // One past the highest id handed out so far (see Catalog::idLimit).
+    uint32_t idLimit() const {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        return nextId;
+    }
+
+    // Upserts every product in `upserts` (price and stock of existing names
+    // are overwritten), applies `adjustments` to the names that still
+    // exist, erases every name in `erasures`, and publishes the result as
+    // one new version. Stock levels are live, so they are stored (or
+    // shifted) just before the version is published rather than with it.
+    PublishStats publish(const std::vector<Product>& upserts,
+                         const std::vector<std::string>& erasures = {},
+                         const std::vector<Adjustment>& adjustments = {}) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        PublishStats stats;
+        const Version* old = current.load();
+        Shard* writable[SHARD_COUNT] = {};
+        auto shardFor = [&](uint32_t hash) -> Shard& {
+            size_t index = shardOf(hash);
+            if (!writable[index]) {
+                writable[index] = new Shard(*old->shards[index]);
+            }
+            return *writable[index];
+        };
+
+        std::vector<const CatalogItem*> retiredItems;
+        std::vector<std::pair<Cell*, const CatalogItem*>> cellUpdates;
+        std::vector<std::pair<Cell*, int>> stockUpdates;
+        std::vector<std::pair<Cell*, int64_t>> stockShifts;
+
+        auto visibleShard = [&](uint32_t hash) -> const Shard& {
+            return writable[shardOf(hash)] ? *writable[shardOf(hash)] : *old->shards[shardOf(hash)];
+        };
+        // Publishes a new item with `price` in place of the one at `pos`.
+        auto replacePrice = [&](uint32_t hash, size_t pos, const CatalogItem* existing, Money price) {
+            Cell* cell = cellOf(existing->getId());
+            Shard& shard = shardFor(hash);
+            const CatalogItem* replacement =
+                new CatalogItem(existing->getName(), price, existing->getId(), &cell->stock);
+            shard.items[shard.buckets[pos].slot] = replacement;
+            retiredItems.push_back(existing);
+            cellUpdates.emplace_back(cell, replacement);
+        };
+
+        for (const Product& product : upserts) {
+            uint32_t hash = Catalog::hashName(product.getName());
+            const Shard& visible = visibleShard(hash);
+            size_t pos = visible.probe(product.getName(), hash);
+            if (visible.buckets[pos].slot != EMPTY) {
+                const CatalogItem* existing = visible.items[visible.buckets[pos].slot];
+                Cell* cell = cellOf(existing->getId());
+                if (existing->getStock() != product.getStock()) {
+                    stockUpdates.emplace_back(cell, product.getStock());
+                }
+                if (existing->getPrice() == product.getPrice()) {
+                    stats.unchanged += existing->getStock() == product.getStock();
+                    stats.updated += existing->getStock() != product.getStock();
+                    continue;
+                }
+                replacePrice(hash, pos, existing, product.getPrice());
+                ++stats.updated;
+                continue;
+            }
+            if ((size_t(nextId) >> CELL_CHUNK_BITS) >= MAX_CHUNKS) {
+                break;  // out of product ids
+            }
+            uint32_t id = nextId++;
+            Cell* cell = claimCell(id);
+            cell->stock.store(product.getStock(), std::memory_order_relaxed);
+            const CatalogItem* item = new CatalogItem(std::string(product.getName()), product.getPrice(), id, &cell->stock);
+            shardFor(hash).insert(item, hash);
+            cellUpdates.emplace_back(cell, item);
+            ++stats.inserted;
+        }
+
+        for (const Adjustment& adjustment : adjustments) {
+            uint32_t hash = Catalog::hashName(adjustment.name);
+            const Shard& visible = visibleShard(hash);
+            size_t pos = visible.probe(adjustment.name, hash);
+            if (visible.buckets[pos].slot == EMPTY) {
+                continue;  // erased since the caller looked it up
+            }
+            const CatalogItem* existing = visible.items[visible.buckets[pos].slot];
+            if (adjustment.stockDelta != 0) {
+                stockShifts.emplace_back(cellOf(existing->getId()), adjustment.stockDelta);
+            }
+            if (existing->getPrice() != adjustment.price) {
+                replacePrice(hash, pos, existing, adjustment.price);
+                ++stats.updated;
+            } else {
+                stats.unchanged += adjustment.stockDelta == 0;
+                stats.updated += adjustment.stockDelta != 0;
+            }
+        }
+
+        for (const std::string& name : erasures) {
+            uint32_t hash = Catalog::hashName(name);
+            const Shard& visible = visibleShard(hash);
+            size_t pos = visible.probe(name, hash);
+            if (visible.buckets[pos].slot == EMPTY) {
+                continue;
+            }
+            Shard& shard = shardFor(hash);
+            const CatalogItem* item = shard.items[shard.buckets[pos].slot];
+            shard.erase(pos);
+            retiredItems.push_back(item);
+            cellUpdates.emplace_back(cellOf(item->getId()), nullptr);
+            ++stats.erased;
+        }
+
+        for (const auto& [cell, stock] : stockUpdates) {
+            cell->stock.store(stock, std::memory_order_relaxed);
+        }
+        for (const auto& [cell, delta] : stockShifts) {
+            Product::shiftStock(cell->stock, delta);
+        }
+
+        Version* next = new Version(*old);
+        bool changed = false;
+        for (size_t i = 0; i < SHARD_COUNT; ++i) {
+            if (writable[i]) {
+                next->shards[i] = writable[i];
+                changed = true;
+            }
+        }
+        if (!changed) {
+            delete next;
+            return stats;
+        }
+        next->size = old->size + stats.inserted - stats.erased;
+        current.store(next);
+
+        for (const auto& [cell, item] : cellUpdates) {
+            cell->item.store(item);
+        }
+        for (size_t i = 0; i < SHARD_COUNT; ++i) {
+            if (writable[i]) {
+                epochs.retire(old->shards[i]);
+            }
+        }
+        epochs.retire(old);
+        for (const CatalogItem* item : retiredItems) {
+            epochs.retire(item);
+        }
+        epochs.collect();
+        return stats;
+    }
+
+    // Publishes every product of `source` under the id it has there, so ids
+    // already recorded against the Catalog (replayed orders, analytics)
+    // keep naming the same products; publish() would number them afresh
+    // and skip the gaps left by erased products. Returns false, changing
+    // nothing, unless this catalog has never held a product.
+    bool publishWithIds(const Catalog& source) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        const Version* old = current.load();
+        if (nextId != 0 || (size_t(source.idLimit()) >> CELL_CHUNK_BITS) >= MAX_CHUNKS) {
+            return false;
+        }
+        Shard* shards[SHARD_COUNT];
+        for (size_t i = 0; i < SHARD_COUNT; ++i) {
+            shards[i] = new Shard;
+        }
+        std::vector<std::pair<Cell*, const CatalogItem*>> cellUpdates;
+        cellUpdates.reserve(source.size());
+        for (const Product& product : source) {
+            Cell* cell = claimCell(product.getId());
+            cell->stock.store(product.getStock(), std::memory_order_relaxed);
+            const CatalogItem* item =
+                new CatalogItem(std::string(product.getName()), product.getPrice(), product.getId(), &cell->stock);
+            uint32_t hash = Catalog::hashName(product.getName());
+            shards[shardOf(hash)]->insert(item, hash);
+            cellUpdates.emplace_back(cell, item);
+        }
+        nextId = source.idLimit();
+
+        Version* next = new Version;
+        for (size_t i = 0; i < SHARD_COUNT; ++i) {
+            next->shards[i] = shards[i];
+        }
+        next->size = source.size();
+        current.store(next);
+        for (const auto& [cell, item] : cellUpdates) {
+            cell->item.store(item);
+        }
+        for (const Shard* shard : old->shards) {
+            epochs.retire(shard);
+        }
+        epochs.retire(old);
+        epochs.collect();
+        return true;
+    }
+
+    // Adds a product or overwrites an existing one's price and stock.
+    // Returns true if a new product was inserted.
+    bool insertOrAssign(Product product) {
+        return publish(std::vector<Product>{std::move(product)}).inserted == 1;
+    }
+
+    bool erase(const std::string& name) {
+        return publish({}, {name}).erased == 1;
+    }
+
+    // Copies the current version into `catalog` (e.g. for CSV export).
+    void copyTo(Catalog& catalog) const {
+        Reader view = read();
+        catalog.reserve(catalog.size() + view.size());
+        for (const CatalogItem& item : view) {
+            catalog.insertOrAssign(Product(item.getName(), item.getPrice(), item.getStock()));
+        }
+    }
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+// SmallVector Class
+// Vector of trivially copyable elements that keeps the first N in an
+// inline buffer and only allocates when it grows past that. Moving a
+// SmallVector that has spilled to the heap just steals the pointer, so a
+// cart can be moved into an order without copying its items.
+template <typename T, size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable_v<T>, "SmallVector only holds trivially copyable types");
+
+    T* data_;
+    size_t size_ = 0;
+    size_t capacity_ = N;
+    alignas(T) unsigned char inlineBuffer[N * sizeof(T)];
+
+    T* inlineData() { return reinterpret_cast<T*>(inlineBuffer); }
+    bool isInline() const { return data_ == reinterpret_cast<const T*>(inlineBuffer); }
+
+    void grow(size_t minCapacity) {
+        size_t newCapacity = capacity_ * 2;
+        if (newCapacity < minCapacity) {
+            newCapacity = minCapacity;
+        }
+        T* fresh = static_cast<T*>(std::malloc(newCapacity * sizeof(T)));
+        if (fresh == nullptr) {
+            throw std::bad_alloc();
+        }
+        std::memcpy(static_cast<void*>(fresh), data_, size_ * sizeof(T));
+        release();
+        data_ = fresh;
+        capacity_ = newCapacity;
+    }
+
+    void release() {
+        if (!isInline()) {
+            std::free(data_);
+        }
+    }
+
+    void takeFrom(SmallVector& other) {
+        if (other.isInline()) {
+            data_ = inlineData();
+            capacity_ = N;
+            std::memcpy(static_cast<void*>(data_), other.data_, other.size_ * sizeof(T));
+        } else {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inlineData();
+            other.capacity_ = N;
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+
+public:
+    SmallVector() : data_(inlineData()) {}
+    ~SmallVector() { release(); }
+
+    SmallVector(const SmallVector& other) : data_(inlineData()) {
+        reserve(other.size_);
+        std::memcpy(static_cast<void*>(data_), other.data_, other.size_ * sizeof(T));
+        size_ = other.size_;
+    }
+
+    SmallVector(SmallVector&& other) noexcept { takeFrom(other); }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            size_ = 0;
+            reserve(other.size_);
+            std::memcpy(static_cast<void*>(data_), other.data_, other.size_ * sizeof(T));
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            release();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return capacity_; }
+
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    T& back() { return data_[size_ - 1]; }
+    const T& back() const { return data_[size_ - 1]; }
+
+    void reserve(size_t count) {
+        if (count > capacity_) {
+            grow(count);
+        }
+    }
+
+    void push_back(const T& value) {
+        if (size_ == capacity_) {
+            T copy = value;  // `value` may live in the buffer being replaced
+            grow(size_ + 1);
+            data_[size_++] = copy;
+            return;
+        }
+        data_[size_++] = value;
+    }
+
+    void pop_back() { --size_; }
+    void clear() { size_ = 0; }
+
+    // Shrinks to `count` elements (count must not exceed size()).
+    void truncate(size_t count) { size_ = count; }
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// StringArena Class
+// Bump-pointer storage for strings. Each intern() copies the text into the
+// current block and returns a view of the copy; views stay valid until the
+// arena is cleared or destroyed. Blocks are never reallocated, so earlier
+// views are not invalidated by later interns.
+class StringArena {
+    static constexpr size_t BLOCK_BYTES = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* cursor = nullptr;
+    size_t remaining = 0;
+    size_t bytesUsed = 0;
+
+public:
+    StringArena() = default;
+    StringArena(StringArena&&) = default;
+    StringArena& operator=(StringArena&&) = default;
+
+    std::string_view intern(std::string_view text) {
+        if (text.size() > remaining) {
+            size_t blockSize = text.size() > BLOCK_BYTES ? text.size() : BLOCK_BYTES;
+            blocks.push_back(std::make_unique<char[]>(blockSize));
+            cursor = blocks.back().get();
+            remaining = blockSize;
+        }
+        if (!text.empty()) {
+            std::memcpy(cursor, text.data(), text.size());
+        }
+        std::string_view stored(cursor, text.size());
+        cursor += text.size();
+        remaining -= text.size();
+        bytesUsed += text.size();
+        return stored;
+    }
+
+    void clear() {
+        blocks.clear();
+        cursor = nullptr;
+        remaining = 0;
+        bytesUsed = 0;
+    }
+
+    size_t size() const { return bytesUsed; }
+};
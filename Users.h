@@ -0,0 +1,478 @@
+#pragma once
+
+#include "BatchCheckout.h"
+#include "Catalog.h"
+#include "CatalogPager.h"
+#include "CatalogSnapshot.h"
+#include "ColumnarCatalog.h"
+#include "CredentialStore.h"
+#include "CsvExporter.h"
+#include "CsvImporter.h"
+#include "CsvSync.h"
+#include "FuzzyMatcher.h"
+#include "Order.h"
+#include "OrderAnalytics.h"
+#include "OrderLog.h"
+#include "Product.h"
+#include "ProductSearch.h"
+#include "ShardedCatalog.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Base User Class
+class User {
+protected:
+    std::string username;
+    std::string password;
+    std::ostream* output = &std::cout;
+
+    std::ostream& out() const { return *output; }
+
+public:
+    User(std::string uname = "", std::string pass = "") : username(uname), password(pass) {}
+    virtual ~User() = default;
+
+    // Where this user's messages go; std::cout unless a server session or
+    // headless driver redirects them.
+    void setOutput(std::ostream& stream) { output = &stream; }
+    virtual void login() = 0; // Pure virtual function for role-specific login
+
+    std::string getUsername() const { return username; }
+    std::string getPassword() const { return password; }
+    virtual void saveCredentials(const std::string& filename) const {
+        std::ofstream file(filename, std::ios::app);
+        if (!file.is_open()) {
+            out() << "Failed to open file for saving user credentials.\n";
+            return;
+        }
+        file << username << "," << password << std::endl;
+        file.close();
+    }
+};
+
+// Admin Class
+class Admin : public User {
+    CsvExporter exporter;
+    // Remembers the last CSV file and feed values applied. Own by default;
+    // server sessions share the server's (see shareProductSync).
+    std::shared_ptr<CsvSync> productSync = std::make_shared<CsvSync>();
+
+    void reportSync(const CsvSync::Stats& stats, const std::string& filename) {
+        if (stats.skipped) {
+            out() << filename << " is unchanged since the last upload; nothing to do.\n";
+            return;
+        }
+        out() << "Synced " << filename << ": " << stats.inserted << " added, " << stats.updated << " updated, "
+              << stats.unchanged << " unchanged, " << stats.deleted << " removed";
+        if (stats.badLines > 0) {
+            out() << ", " << stats.badLines << " invalid lines skipped";
+        }
+        out() << ".\n";
+    }
+
+public:
+    Admin(std::string uname, std::string pass) : User(uname, pass) {}
+
+    void login() override {
+        out() << "Admin login successful!\n";
+    }
+
+    // Syncs through `sync` from now on. Everything that syncs one catalog
+    // must share one CsvSync, or feed changes are applied once per copy.
+    void shareProductSync(std::shared_ptr<CsvSync> sync) { productSync = std::move(sync); }
+
+    // Re-syncs the catalog with the CSV file (see CsvSync): only new and
+    // changed rows are written, and with deleteMissing products no longer
+    // in the file are removed. An unchanged file is skipped.
+    void uploadProductsFromCSV(Catalog& catalog, const std::string& filename, bool deleteMissing = false) {
+        CsvSync::Stats stats;
+        unsigned threads = std::thread::hardware_concurrency();
+        if (!productSync->sync(catalog, filename, deleteMissing, stats, threads == 0 ? 1 : threads, out())) {
+            out() << "Failed to open CSV file: " << filename << "\n";
+            return;
+        }
+        reportSync(stats, filename);
+    }
+
+    // Same for a ShardedCatalog; the changes are published as one version
+    // so readers see all of the upload or none of it.
+    void uploadProductsFromCSV(ShardedCatalog& catalog, const std::string& filename, bool deleteMissing = false) {
+        CsvSync::Stats stats;
+        unsigned threads = std::thread::hardware_concurrency();
+        if (!productSync->sync(catalog, filename, deleteMissing, stats, threads == 0 ? 1 : threads, out())) {
+            out() << "Failed to open CSV file: " << filename << "\n";
+            return;
+        }
+        reportSync(stats, filename);
+    }
+
+    // Save the product catalog to CSV
+    void saveProductsToCSV(const Catalog& catalog, const std::string& filename) {
+        if (!exporter.exportFile(catalog, filename)) {
+            out() << "Failed to write CSV file: " << filename << "\n";
+            return;
+        }
+
+        out() << "Product catalog saved to " << filename << "!\n";
+    }
+
+    void saveProductsToCSV(const ShardedCatalog& catalog, const std::string& filename) {
+        Catalog copy;
+        catalog.copyTo(copy);
+        saveProductsToCSV(copy, filename);
+    }
+
+    // Binary sibling of saveProductsToCSV; see CatalogSnapshot.
+    void saveProductsToSnapshot(const Catalog& catalog, const std::string& filename) {
+        if (!CatalogSnapshot::write(catalog, filename)) {
+            out() << "Failed to write snapshot file: " << filename << "\n";
+            return;
+        }
+
+        out() << "Product catalog snapshot saved to " << filename << "!\n";
+    }
+
+    // Copies the snapshot into `catalog` row by row (see CatalogSnapshot);
+    // faster than re-parsing the CSV, but linear in its size.
+    void loadProductsFromSnapshot(Catalog& catalog, const std::string& filename) {
+        CatalogSnapshot snapshot;
+        if (!snapshot.open(filename)) {
+            out() << "Failed to open snapshot file (missing or incompatible): " << filename << "\n";
+            return;
+        }
+
+        snapshot.loadInto(catalog);
+        productSync->reset();
+        out() << snapshot.size() << " products loaded from " << filename << "!\n";
+    }
+
+    // Prompts for a product on std::cin and adds it.
+    void addProduct(Catalog& catalog) {
+        std::string name;
+        Money price;
+        int stock;
+        out() << "Enter product name: ";
+        std::getline(std::cin, name);
+        out() << "Enter product price: ";
+        std::cin >> price;
+        out() << "Enter product stock: ";
+        std::cin >> stock;
+        clearInputBuffer();
+
+        addProduct(catalog, Product(name, price, stock));
+    }
+
+    template <typename CatalogType>
+    void addProduct(CatalogType& catalog, Product product) {
+        if (catalog.insertOrAssign(std::move(product))) {
+            out() << "Product added successfully.\n";
+        } else {
+            out() << "Product already existed; price and stock updated.\n";
+        }
+    }
+
+    // Checks out a marketplace batch of carts (see BatchCheckout) and
+    // reports throughput and the time spent in each stage.
+    void importOrderBatch(Catalog& catalog, const std::string& filename, std::vector<Order>& orders,
+                          OrderLog* orderLog = nullptr, OrderAnalytics* analytics = nullptr) {
+        unsigned threads = std::thread::hardware_concurrency();
+        BatchCheckout batch(threads == 0 ? 1 : threads);
+        BatchCheckout::Result result;
+        if (!batch.processFile(catalog, filename, orders, result, orderLog, analytics)) {
+            out() << "Failed to open order batch: " << filename << "\n";
+            return;
+        }
+        const BatchCheckout::StageSeconds& seconds = result.seconds;
+        out() << "Checked out " << result.carts << " carts in " << seconds.total() << " s ("
+              << static_cast<uint64_t>(result.carts / std::max(seconds.total(), 1e-9)) << " orders/sec): "
+              << result.placed << " placed ($" << result.revenue << "), " << result.outOfStock << " out of stock, "
+              << result.unknownProduct << " with unknown products";
+        if (result.logFailed > 0) {
+            out() << ", " << result.logFailed << " not placed because the order log failed";
+        }
+        if (result.badLines > 0) {
+            out() << ", " << result.badLines << " invalid lines skipped";
+        }
+        out() << ".\n";
+        out() << "Stage times (ms): parse " << seconds.parse * 1000 << ", validate " << seconds.validate * 1000
+              << ", reserve " << seconds.reserve * 1000 << ", price " << seconds.price * 1000 << ", log "
+              << seconds.log * 1000 << "\n";
+    }
+
+    // Aggregates over the columnar copy of the catalog (rebuilt if stale).
+    void showInventoryReport(const Catalog& catalog, ColumnarCatalog& columns) {
+        const int lowStockThreshold = 5;
+        columns.refresh(catalog);
+        out() << "Inventory Report:\n";
+        out() << "Products: " << columns.size() << "\n";
+        out() << "Units in stock: " << columns.totalUnits() << "\n";
+        out() << "Out of stock: " << columns.countBelowStock(1) << "\n";
+        std::vector<uint32_t> lowRows = columns.lowStock(lowStockThreshold);
+        out() << "Low stock (below " << lowStockThreshold << "): " << lowRows.size() << "\n";
+        for (size_t i = 0; i < lowRows.size() && i < 10; ++i) {
+            out() << "- " << columns.nameAt(lowRows[i]) << " (" << columns.stockAt(lowRows[i]) << " left)\n";
+        }
+        out() << "Total inventory value: $" << columns.totalInventoryValue() << "\n";
+    }
+
+    // Best sellers and customers from the running aggregates; takes a
+    // Catalog or a ShardedCatalog::Reader for product names.
+    template <typename CatalogView>
+    void showSalesReport(const CatalogView& catalog, const OrderAnalytics& analytics) {
+        const size_t topCount = 5;
+        auto productName = [&](uint32_t id) {
+            const auto* product = catalog.findById(id);
+            return product ? std::string(product->getName()) : "(removed product #" + std::to_string(id) + ")";
+        };
+        out() << "Sales Report:\n";
+        out() << "Orders: " << analytics.orderCount() << ", revenue: $" << analytics.totalRevenue() << "\n";
+        out() << "Top sellers today (units):\n";
+        for (const OrderAnalytics::RankedProduct& ranked : analytics.topSellersToday(topCount)) {
+            out() << "- " << productName(ranked.key) << " (about " << ranked.count << ")\n";
+        }
+        out() << "Top products by revenue:\n";
+        for (const OrderAnalytics::RankedProduct& ranked : analytics.topProductsByRevenue(topCount)) {
+            OrderAnalytics::ProductTotals totals = analytics.productTotals(ranked.key);
+            out() << "- " << productName(ranked.key) << ": $" << totals.revenue << " (" << totals.units
+                  << " units in " << totals.orders << " orders)\n";
+        }
+        out() << "Top customers by spend:\n";
+        for (const OrderAnalytics::RankedCustomer& ranked : analytics.topCustomers(topCount)) {
+            OrderAnalytics::CustomerTotals totals = analytics.customerTotals(ranked.key);
+            out() << "- " << ranked.key << ": $" << totals.spend << " (" << totals.orders << " orders)\n";
+        }
+    }
+
+private:
+    // Helper function to clear the input buffer
+    void clearInputBuffer() {
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+};
+
+// Customer Class
+class Customer : public User {
+    LineItems cart;
+    std::vector<std::string> orderHistory;
+    CatalogPager pager;
+
+    bool showPage(const CatalogPager::Page& page) {
+        out().write(page.text.data(), static_cast<std::streamsize>(page.text.size()));
+        out().flush();
+        return page.hasMore();
+    }
+
+public:
+    Customer(std::string uname, std::string pass) : User(uname, pass) {}
+
+    void login() override {
+        out() << "Customer login successful!\n";
+    }
+
+    // The catalog-reading operations below take either a Catalog or a
+    // ShardedCatalog::Reader.
+
+    // Shows one page of the catalog with a single write (see CatalogPager).
+    // Returns true if more pages follow.
+    template <typename CatalogView>
+    bool browseProducts(const CatalogView& catalog, size_t offset = 0,
+                        size_t limit = CatalogPager::DEFAULT_PAGE_SIZE) {
+        return showPage(pager.render(catalog, offset, limit));
+    }
+
+    // Shows the page after the last one browsed.
+    template <typename CatalogView>
+    bool browseNextPage(const CatalogView& catalog, size_t limit = CatalogPager::DEFAULT_PAGE_SIZE) {
+        return showPage(pager.next(catalog, limit));
+    }
+
+    // Lists products priced within [minPrice, maxPrice] with at least
+    // minStock units, using the columnar copy of the catalog.
+    void filterProducts(const Catalog& catalog, ColumnarCatalog& columns,
+                        Money minPrice, Money maxPrice, int minStock) {
+        columns.refresh(catalog);
+        std::vector<uint32_t> rows = columns.filter(minPrice, maxPrice, minStock);
+        if (rows.empty()) {
+            out() << "No products match your filter.\n";
+            return;
+        }
+        out() << rows.size() << " matching products:\n";
+        for (uint32_t row : rows) {
+            catalog.items()[row].displayProduct(out());
+        }
+    }
+
+    // Lists products whose names start with `query` (autocomplete) and
+    // products whose names contain every word of it.
+    void searchProducts(const Catalog& catalog, ProductSearch& search, const std::string& query) {
+        const size_t maxResults = 10;
+        search.refresh(catalog);
+        auto isLive = [&](uint32_t id) { return catalog.findById(id) != nullptr; };
+        std::vector<uint32_t> byPrefix = search.prefixSearch(query, maxResults, isLive);
+        std::vector<uint32_t> byWords = search.keywordSearch(query, maxResults, isLive);
+        if (byPrefix.empty() && byWords.empty()) {
+            out() << "No products match \"" << query << "\".\n";
+            return;
+        }
+        if (!byPrefix.empty()) {
+            out() << "Names starting with \"" << query << "\":\n";
+            for (uint32_t id : byPrefix) {
+                catalog.findById(id)->displayProduct(out());
+            }
+        }
+        if (!byWords.empty()) {
+            out() << "Names containing \"" << query << "\":\n";
+            for (uint32_t id : byWords) {
+                catalog.findById(id)->displayProduct(out());
+            }
+        }
+    }
+
+    // For a cart add whose name matched no product: returns the closest
+    // product name within a few typos, or "" if there is none. When several
+    // names are equally close they are listed instead and "" is returned.
+    std::string suggestProduct(const Catalog& catalog, FuzzyMatcher& matcher, const std::string& name) {
+        const size_t maxSuggestions = 5;
+        matcher.refresh(catalog);
+        auto isLive = [&](uint32_t id) { return catalog.findById(id) != nullptr; };
+        std::vector<FuzzyMatcher::Match> matches = matcher.closest(name, maxSuggestions, isLive);
+        if (matches.empty()) {
+            out() << "Product not found: " << name << "\n";
+            return "";
+        }
+        if (matches.size() == 1 || matches[1].distance > matches[0].distance) {
+            return std::string(catalog.findById(matches[0].id)->getName());
+        }
+        out() << "Product not found: " << name << ". Did you mean one of these?\n";
+        for (const FuzzyMatcher::Match& match : matches) {
+            if (match.distance == matches[0].distance) {
+                catalog.findById(match.id)->displayProduct(out());
+            }
+        }
+        return "";
+    }
+
+    template <typename CatalogView>
+    bool addToCart(const CatalogView& catalog, const std::string& product, uint32_t quantity = 1) {
+        const auto* found = catalog.find(product);
+        if (!found) {
+            out() << "Product not found: " << product << "\n";
+            return false;
+        }
+        if (quantity == 0) {
+            out() << "Quantity must be at least 1.\n";
+            return false;
+        }
+
+        LineItem* existing = nullptr;
+        for (LineItem& item : cart) {
+            if (item.productId == found->getId()) {
+                existing = &item;
+                break;
+            }
+        }
+        // Stock levels are ints, so a line may not hold more than INT32_MAX
+        // units; summed in 64 bits so repeated adds cannot wrap around.
+        if ((existing ? uint64_t(existing->quantity) : 0) + quantity > INT32_MAX) {
+            out() << "Cannot hold more than " << INT32_MAX << " x " << product << " in the cart.\n";
+            return false;
+        }
+        if (existing) {
+            existing->quantity += quantity;
+            out() << product << " quantity in cart is now " << existing->quantity << "!\n";
+            return true;
+        }
+        cart.push_back(LineItem{found->getId(), quantity, Money()});
+        out() << quantity << " x " << product << " added to cart!\n";
+        return true;
+    }
+
+    // Prices the cart at current catalog prices, reserves stock for every
+    // item (all or nothing) and moves the cart into a new order. Items
+    // whose product was removed since are left out. If some item is short
+    // of stock, nothing is reserved and the cart is kept. With an order log the
+    // order only counts once it is durable; otherwise the stock is given
+    // back and the cart kept. Placed orders are added to `analytics`, if
+    // given.
+    template <typename CatalogView>
+    void checkout(CatalogView& catalog, std::vector<Order>& orders, OrderLog* orderLog = nullptr,
+                  OrderAnalytics* analytics = nullptr) {
+        if (cart.empty()) {
+            out() << "Your cart is empty!\n";
+            return;
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < cart.size(); ++i) {
+            const auto* product = catalog.findById(cart[i].productId);
+            if (!product) {
+                out() << "An item in your cart is no longer available and was left out of the order.\n";
+                continue;
+            }
+            cart[i].unitPrice = product->getPrice();
+            cart[kept++] = cart[i];
+        }
+        cart.truncate(kept);
+        if (cart.empty()) {
+            out() << "None of the items in your cart are available.\n";
+            return;
+        }
+
+        long failed = catalog.reserveStock(cart);
+        if (failed >= 0) {
+            const auto* product = catalog.findById(cart[failed].productId);
+            if (product) {
+                out() << "Not enough stock for " << product->getName() << " (requested "
+                      << cart[failed].quantity << ", available " << product->getStock() << ").\n";
+            }
+            out() << "Your cart was kept as it is; no order was placed.\n";
+            return;
+        }
+
+        Order order(username, std::move(cart));
+        cart.clear();
+        if (orderLog && !orderLog->append(order, catalog)) {
+            catalog.releaseStock(order.getItems());
+            cart = order.getItems();
+            out() << "Failed to record the order in " << orderLog->getFilename()
+                  << "; no order was placed.\n";
+            return;
+        }
+        if (analytics) {
+            analytics->record(order);
+        }
+        orders.push_back(std::move(order));
+        out() << "Order placed successfully! Total: $" << orders.back().total() << "\n";
+    }
+
+    bool verifyCredentials(const CredentialStore& credentials) {
+        return credentials.verify(username, password);
+    }
+
+    bool registerUser(CredentialStore& credentials) {
+        switch (credentials.registerAccount(username, password)) {
+            case RegisterResult::Registered:
+                out() << "Registration successful!\n";
+                return true;
+            case RegisterResult::UsernameTaken:
+                out() << "Username already exists! Please try again with a different username.\n";
+                return false;
+            case RegisterResult::InvalidName:
+                out() << "Usernames cannot be empty or contain commas.\n";
+                return false;
+            case RegisterResult::StorageError:
+                break;
+        }
+        out() << "Failed to save user account to " << credentials.getFilename() << "\n";
+        return false;
+    }
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+// Shared helpers for the stand-alone benchmark programs in bench/.
+
+class Stopwatch {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+public:
+    void reset() { start = std::chrono::steady_clock::now(); }
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+// Parses argv[index] as a count, falling back to `fallback`.
+inline size_t argCount(int argc, char** argv, int index, size_t fallback) {
+    if (argc > index) {
+        return static_cast<size_t>(std::strtoull(argv[index], nullptr, 10));
+    }
+    return fallback;
+}
+
+// Deterministic synthetic product name, unique per index.
+inline std::string syntheticProductName(size_t index) {
+    return "Product-" + std::to_string(index);
+}
+
+// Writes a products.csv-style file (with header) of `rows` unique products.
+inline void writeSyntheticProductsCSV(const std::string& filename, size_t rows) {
+    std::ofstream file(filename, std::ios::binary);
+    file << "Product Name,Price,Stock\n";
+    std::string line;
+    for (size_t i = 0; i < rows; ++i) {
+        line = syntheticProductName(i);
+        line += ',';
+        line += std::to_string(1 + (i * 7919) % 100000 / 100.0);
+        line += ',';
+        line += std::to_string((i * 31) % 500);
+        line += '\n';
+        file.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+}
+
+// Deterministic synthetic account, unique per index.
+inline std::string syntheticUserName(size_t index) {
+    return "user" + std::to_string(index);
+}
+
+inline std::string syntheticPassword(size_t index) {
+    return "pw" + std::to_string(index * 2654435761u % 1000003);
+}
+
+// Writes an accounts.txt-style file of `users` synthetic accounts.
+inline void writeSyntheticAccounts(const std::string& filename, size_t users) {
+    std::ofstream file(filename, std::ios::binary);
+    std::string line;
+    for (size_t i = 0; i < users; ++i) {
+        line = syntheticUserName(i);
+        line += ',';
+        line += syntheticPassword(i);
+        line += '\n';
+        file.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+}
+
+inline void printRate(const char* label, size_t items, double seconds, const char* unit) {
+    std::printf("%-28s %12zu %s in %8.3f s  -> %14.0f %s/sec\n",
+                label, items, unit, seconds, items / seconds, unit);
+}
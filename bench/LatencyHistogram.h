@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// LatencyHistogram Class
+// HDR-style latency histogram over nanoseconds: log-linear buckets, exact
+// below 128 ns and within 1/64 (1.6%) of the value above, across the
+// whole uint64 range, in a fixed 30 KB. Recording is a few instructions
+// and histograms from several threads can be merged.
+class LatencyHistogram {
+    static constexpr unsigned SUB_BITS = 7;  // 128 exact values, then 64 buckets per power of two
+    static constexpr uint64_t EXACT = uint64_t(1) << SUB_BITS;
+    static constexpr size_t HALF = EXACT / 2;
+    static constexpr size_t BUCKETS = EXACT + (64 - SUB_BITS) * HALF;
+
+    std::array<uint64_t, BUCKETS> counts{};
+    uint64_t total = 0;
+    uint64_t minValue = UINT64_MAX;
+    uint64_t maxValue = 0;
+    long double sum = 0;
+
+    static size_t indexOf(uint64_t value) {
+        if (value < EXACT) {
+            return static_cast<size_t>(value);
+        }
+        unsigned exponent = 63 - static_cast<unsigned>(std::countl_zero(value));  // >= SUB_BITS
+        unsigned shift = exponent - (SUB_BITS - 1);
+        return EXACT + (exponent - SUB_BITS) * HALF + static_cast<size_t>((value >> shift) - HALF);
+    }
+
+    // Largest value that falls in bucket `index`.
+    static uint64_t highestIn(size_t index) {
+        if (index < EXACT) {
+            return index;
+        }
+        unsigned exponent = static_cast<unsigned>((index - EXACT) / HALF) + SUB_BITS;
+        unsigned shift = exponent - (SUB_BITS - 1);
+        uint64_t low = (HALF + (index - EXACT) % HALF) << shift;
+        return low + ((uint64_t(1) << shift) - 1);
+    }
+
+public:
+    void record(uint64_t nanos) {
+        ++counts[indexOf(nanos)];
+        ++total;
+        minValue = std::min(minValue, nanos);
+        maxValue = std::max(maxValue, nanos);
+        sum += nanos;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+        sum += other.sum;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total ? minValue : 0; }
+    uint64_t max() const { return maxValue; }
+    double mean() const { return total ? static_cast<double>(sum / total) : 0.0; }
+
+    // The value at quantile q (0..1): the top of the bucket holding it,
+    // so it is never below the true value and at most 1.6% above it.
+    uint64_t percentile(double q) const {
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return std::min(highestIn(i), maxValue);
+            }
+        }
+        return maxValue;
+    }
+};
@@ -0,0 +1,144 @@
+// Batch checkout pipeline: writes a batch of carts whose products follow a
+// Zipf distribution (s = 1.1, so a few SKUs are heavily contended and run
+// out of stock), checks it out with BatchCheckout on 1 and N threads and
+// reports orders/sec with per-stage timings. Every run's per-cart outcomes
+// are compared with checking the carts out one by one in file order.
+//
+// Usage: bench_batch_checkout [carts] [threads] [products] [log]
+//        (default 1,000,000 carts, hardware threads, 100,000 products;
+//        "log" also appends the placed orders to an order log)
+
+#include "BatchCheckout.h"
+#include "BenchUtil.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const int STOCK_PER_PRODUCT = 1000;
+
+static void fillCatalog(Catalog& catalog, size_t products) {
+    catalog.clear();
+    catalog.reserve(products);
+    for (size_t i = 0; i < products; ++i) {
+        std::string name = syntheticProductName(i);
+        catalog.insert(Product(name, Money::fromCents(static_cast<int64_t>(199 + i % 10000)), STOCK_PER_PRODUCT));
+    }
+}
+
+static void writeBatch(const std::string& filename, size_t carts, size_t products) {
+    std::vector<double> popularity(products);
+    double sum = 0.0;
+    for (size_t i = 0; i < products; ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), 1.1);
+        popularity[i] = sum;
+    }
+    std::mt19937_64 rng(23);
+    std::uniform_real_distribution<double> uniform(0.0, sum);
+    std::ofstream file(filename, std::ios::binary);
+    file << BatchCheckout::HEADER << "\n";
+    std::string line;
+    for (size_t i = 0; i < carts; ++i) {
+        line = "customer-" + std::to_string(rng() % 100000);
+        for (size_t item = 0, items = 1 + rng() % 4; item < items; ++item) {
+            size_t product = std::lower_bound(popularity.begin(), popularity.end(), uniform(rng)) - popularity.begin();
+            line += ',';
+            line += syntheticProductName(std::min(product, products - 1));
+            line += ',';
+            line += std::to_string(1 + rng() % 3);
+        }
+        line += '\n';
+        file.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+}
+
+// The outcomes of checking out the carts one at a time, as Customer::checkout would.
+static std::vector<BatchCheckout::Outcome> sequentialOutcomes(const std::string& filename, size_t products) {
+    Catalog catalog;
+    fillCatalog(catalog, products);
+    std::vector<BatchCheckout::Outcome> outcomes;
+    std::ifstream file(filename);
+    std::string line;
+    std::getline(file, line);  // header
+    while (std::getline(file, line)) {
+        std::string_view rest(line);
+        rest.remove_prefix(rest.find(',') + 1);
+        LineItems items;
+        bool known = true;
+        while (!rest.empty()) {
+            size_t comma = rest.find(',');
+            const Product* product = catalog.find(rest.substr(0, comma));
+            rest.remove_prefix(comma + 1);
+            size_t next = rest.find(',');
+            uint32_t quantity = static_cast<uint32_t>(std::stoul(std::string(rest.substr(0, next))));
+            rest.remove_prefix(next == std::string_view::npos ? rest.size() : next + 1);
+            if (!product) {
+                known = false;
+                continue;
+            }
+            auto same = std::find_if(items.begin(), items.end(),
+                                     [&](const LineItem& item) { return item.productId == product->getId(); });
+            if (same != items.end()) {
+                same->quantity += quantity;
+            } else {
+                items.push_back(LineItem{product->getId(), quantity, Money()});
+            }
+        }
+        if (!known) {
+            outcomes.push_back(BatchCheckout::Outcome::UnknownProduct);
+        } else {
+            outcomes.push_back(catalog.reserveStock(items) < 0 ? BatchCheckout::Outcome::Placed
+                                                               : BatchCheckout::Outcome::OutOfStock);
+        }
+    }
+    return outcomes;
+}
+
+int main(int argc, char** argv) {
+    size_t carts = argCount(argc, argv, 1, 1000000);
+    unsigned threads = static_cast<unsigned>(
+        argCount(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency())));
+    size_t products = std::max<size_t>(1, argCount(argc, argv, 3, 100000));
+    bool withLog = argc > 4 && std::string(argv[4]) == "log";
+    const std::string batchFile = "bench_order_batch.csv";
+    const std::string logFile = "bench_batch_orders.log";
+    writeBatch(batchFile, carts, products);
+
+    std::vector<BatchCheckout::Outcome> expected = sequentialOutcomes(batchFile, products);
+    std::vector<unsigned> threadCounts{1};
+    if (threads > 1) {
+        threadCounts.push_back(threads);
+    }
+    for (unsigned count : threadCounts) {
+        Catalog catalog;
+        fillCatalog(catalog, products);
+        std::remove(logFile.c_str());
+        OrderLog orderLog(logFile);
+        std::vector<Order> restored;
+        OrderLog::ReplayStats replay;
+        if (withLog && !orderLog.open(catalog, restored, replay)) {
+            std::printf("cannot open %s\n", logFile.c_str());
+            return 1;
+        }
+
+        BatchCheckout batch(count);
+        BatchCheckout::Result result;
+        std::vector<Order> orders;
+        batch.processFile(catalog, batchFile, orders, result, withLog ? &orderLog : nullptr);
+        const BatchCheckout::StageSeconds& s = result.seconds;
+        std::printf("%2u threads: %zu carts -> %zu placed, %zu out of stock; %.0f orders/sec%s\n", count,
+                    result.carts, result.placed, result.outOfStock, result.carts / s.total(),
+                    result.outcomes == expected ? " (matches sequential)" : " (DIFFERS from sequential)");
+        std::printf("            parse %.1f ms, validate %.1f ms, reserve %.1f ms, price %.1f ms, log %.1f ms\n",
+                    s.parse * 1e3, s.validate * 1e3, s.reserve * 1e3, s.price * 1e3, s.log * 1e3);
+    }
+
+    std::remove(batchFile.c_str());
+    std::remove(logFile.c_str());
+    return 0;
+}
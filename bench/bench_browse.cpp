@@ -0,0 +1,61 @@
+// Browse rendering throughput: the old displayProduct loop (one formatted
+// iostream write plus std::endl flush per product) versus CatalogPager
+// pages rendered with to_chars and written with one write() each. Output
+// goes to /dev/null so only formatting and write costs are measured.
+//
+// Usage: bench_browse [products] [page size]   (default 1000000, 1000)
+
+#include "BenchUtil.h"
+#include "Catalog.h"
+#include "CatalogPager.h"
+#include "FileUtil.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+int main(int argc, char** argv) {
+    size_t count = argCount(argc, argv, 1, 1000000);
+    size_t pageSize = argCount(argc, argv, 2, 1000);
+
+    Catalog catalog;
+    catalog.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string name = syntheticProductName(i);
+        catalog.insert(Product(name, Money::fromCents(100 + static_cast<int64_t>((i * 7919) % 100000)),
+                               static_cast<int>((i * 31) % 500)));
+    }
+
+    {
+        std::ofstream sink("/dev/null");
+        Stopwatch timer;
+        for (const Product& product : catalog) {
+            product.displayProduct(sink);
+        }
+        printRate("displayProduct loop", count, timer.seconds(), "products");
+    }
+    {
+        int fd = ::open("/dev/null", O_WRONLY);
+        CatalogPager pager;
+        size_t rendered = 0;
+        size_t bytes = 0;
+        Stopwatch timer;
+        CatalogPager::Page page = pager.render(catalog, 0, pageSize);
+        while (true) {
+            writeAll(fd, page.text.data(), page.text.size());
+            rendered += page.count;
+            bytes += page.text.size();
+            if (!page.hasMore()) {
+                break;
+            }
+            page = pager.next(catalog, pageSize);
+        }
+        double seconds = timer.seconds();
+        ::close(fd);
+        printRate("CatalogPager pages", rendered, seconds, "products");
+        std::printf("%-28s %zu-product pages, %.1f MB\n", "", pageSize, bytes / 1e6);
+    }
+    return 0;
+}
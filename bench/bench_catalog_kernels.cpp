@@ -0,0 +1,68 @@
+// Price/stock scan kernels: scalar loops versus the AVX2 versions, on
+// synthetic price (cents) and stock columns.
+//
+// Usage: bench_catalog_kernels [products] [repeats]   (default 10,000,000 x 10)
+
+#include "BenchUtil.h"
+#include "CatalogKernels.h"
+#include "Money.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+static void runTable(const CatalogKernels::Table& kernels, const std::vector<int64_t>& prices,
+                     const std::vector<int>& stocks, size_t repeats) {
+    size_t count = prices.size();
+    std::vector<uint32_t> rows(count);
+    size_t matches = 0;
+    int64_t value = 0;
+    std::string label;
+
+    Stopwatch timer;
+    for (size_t r = 0; r < repeats; ++r) {
+        matches = kernels.filterRange(prices.data(), stocks.data(), count, 10000, 50000, 1, rows.data());
+    }
+    label = std::string(kernels.name) + " filterRange";
+    printRate(label.c_str(), count * repeats, timer.seconds(), "products");
+    std::printf("%-28s %12zu matches\n", "", matches);
+
+    timer.reset();
+    for (size_t r = 0; r < repeats; ++r) {
+        value = kernels.inventoryValue(prices.data(), stocks.data(), count);
+    }
+    label = std::string(kernels.name) + " inventoryValue";
+    printRate(label.c_str(), count * repeats, timer.seconds(), "products");
+    std::printf("%-28s %12s total\n", "", Money::fromCents(value).toString().c_str());
+
+    timer.reset();
+    for (size_t r = 0; r < repeats; ++r) {
+        matches = kernels.lowStock(stocks.data(), count, 5, rows.data());
+    }
+    label = std::string(kernels.name) + " lowStock";
+    printRate(label.c_str(), count * repeats, timer.seconds(), "products");
+    std::printf("%-28s %12zu matches\n", "", matches);
+}
+
+int main(int argc, char** argv) {
+    size_t count = argCount(argc, argv, 1, 10000000);
+    size_t repeats = argCount(argc, argv, 2, 10);
+
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int64_t> priceDist(100, 100000);  // cents
+    std::uniform_int_distribution<int> stockDist(0, 200);
+    std::vector<int64_t> prices(count);
+    std::vector<int> stocks(count);
+    for (size_t i = 0; i < count; ++i) {
+        prices[i] = priceDist(rng);
+        stocks[i] = stockDist(rng);
+    }
+
+    runTable(CatalogKernels::scalar(), prices, stocks, repeats);
+    if (const CatalogKernels::Table* avx2 = CatalogKernels::avx2()) {
+        runTable(*avx2, prices, stocks, repeats);
+    } else {
+        std::printf("AVX2 kernels not available on this CPU/build\n");
+    }
+    return 0;
+}
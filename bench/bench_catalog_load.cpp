@@ -0,0 +1,77 @@
+// Catalog load time and memory: writes a products.csv with realistic
+// (longer than small-string-optimization) names, imports it with
+// CsvImporter and reports the load time, peak RSS and the RSS the loaded
+// catalog keeps once the file is unmapped.
+//
+// Usage: bench_catalog_load [rows] [threads]   (default 10,000,000 rows)
+
+#include "BenchUtil.h"
+#include "CsvImporter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+static const char* const ADJECTIVES[] = {"Wireless", "Portable", "Compact", "Deluxe", "Classic", "Rugged"};
+static const char* const NOUNS[] = {"Headphones", "Keyboard", "Backpack", "Speaker", "Monitor", "Blender"};
+
+static void writeProductsCSV(const std::string& filename, size_t rows) {
+    std::ofstream file(filename, std::ios::binary);
+    file << "Product Name,Price,Stock\n";
+    std::string line;
+    for (size_t i = 0; i < rows; ++i) {
+        line = ADJECTIVES[i % 6];
+        line += ' ';
+        line += NOUNS[(i / 6) % 6];
+        line += ' ';
+        line += syntheticProductName(i);
+        line += ',';
+        line += std::to_string(1 + (i * 7919) % 100000 / 100.0);
+        line += ',';
+        line += std::to_string((i * 31) % 500);
+        line += '\n';
+        file.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+}
+
+static double residentMiB() {
+    long pages = 0, resident = 0;
+    if (FILE* statm = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        std::fclose(statm);
+    }
+    return static_cast<double>(resident) * sysconf(_SC_PAGESIZE) / (1 << 20);
+}
+
+static double peakMiB() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+int main(int argc, char** argv) {
+    size_t rows = argCount(argc, argv, 1, 10000000);
+    unsigned threads = static_cast<unsigned>(
+        argCount(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency())));
+    const std::string filename = "bench_load_products.csv";
+    writeProductsCSV(filename, rows);
+
+    double before = residentMiB();
+    Catalog catalog;
+    CsvImporter::Stats stats;
+    Stopwatch timer;
+    CsvImporter::importFile(catalog, filename, stats, threads);
+    printRate("load", stats.rowsImported, timer.seconds(), "rows");
+    std::printf("peak RSS %.1f MiB, catalog resident %.1f MiB (%.1f bytes/product)\n", peakMiB(),
+                residentMiB() - before, (residentMiB() - before) * (1 << 20) / std::max<size_t>(1, catalog.size()));
+
+    std::remove(filename.c_str());
+    return 0;
+}
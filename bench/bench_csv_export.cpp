@@ -0,0 +1,46 @@
+// CSV export throughput: the original ofstream/toCSV()/endl loop versus the
+// buffered, to_chars based CsvExporter with write-temp-then-rename.
+//
+// Usage: bench_csv_export [rows]   (default 10,000,000)
+
+#include "BenchUtil.h"
+#include "CsvExporter.h"
+
+#include <fstream>
+#include <string>
+
+// The pre-CsvExporter Admin::saveProductsToCSV loop, kept for comparison.
+static void legacySave(const Catalog& catalog, const std::string& filename) {
+    std::ofstream file(filename);
+    for (const auto& product : catalog) {
+        file << product.toCSV() << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t rows = argCount(argc, argv, 1, 10000000);
+    const std::string filename = "bench_export.csv";
+
+    Catalog catalog;
+    catalog.reserve(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        std::string name = syntheticProductName(i);
+        catalog.insert(Product(name, Money::fromCents(100 + static_cast<int64_t>((i * 7919) % 100000)),
+                               static_cast<int>((i * 31) % 500)));
+    }
+
+    {
+        Stopwatch timer;
+        legacySave(catalog, filename);
+        printRate("legacy toCSV + endl", rows, timer.seconds(), "rows");
+    }
+    {
+        CsvExporter exporter;
+        Stopwatch timer;
+        exporter.exportFile(catalog, filename);
+        printRate("buffered to_chars", rows, timer.seconds(), "rows");
+    }
+
+    std::remove(filename.c_str());
+    return 0;
+}
@@ -0,0 +1,72 @@
+// CSV import throughput: the original stringstream/operator>> loop versus
+// the memory-mapped, from_chars based CsvImporter, serial and chunked across
+// 2, 4, ... up to hardware_concurrency threads.
+//
+// Usage: bench_csv_import [rows] [max threads]   (default 1,000,000 rows)
+
+#include "BenchUtil.h"
+#include "CsvImporter.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// The pre-CsvImporter Admin::uploadProductsFromCSV loop, kept for comparison.
+static size_t legacyUpload(Catalog& catalog, const std::string& filename) {
+    std::ifstream file(filename);
+    std::string line, name;
+    double price;
+    int stock;
+    size_t rows = 0;
+
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::getline(ss, name, ',');
+        if (!(ss >> price)) {
+            continue;
+        }
+        ss.ignore();
+        if (!(ss >> stock)) {
+            continue;
+        }
+        catalog.insertOrAssign(Product(name, Money::fromDouble(price), stock));
+        ++rows;
+    }
+    return rows;
+}
+
+int main(int argc, char** argv) {
+    size_t rows = argCount(argc, argv, 1, 1000000);
+    const std::string filename = "bench_products.csv";
+    writeSyntheticProductsCSV(filename, rows);
+
+    {
+        Catalog catalog;
+        Stopwatch timer;
+        size_t imported = legacyUpload(catalog, filename);
+        printRate("legacy stringstream", imported, timer.seconds(), "rows");
+    }
+    {
+        Catalog catalog;
+        CsvImporter::Stats stats;
+        Stopwatch timer;
+        CsvImporter::importFile(catalog, filename, stats);
+        printRate("mmap + from_chars", stats.rowsImported, timer.seconds(), "rows");
+    }
+
+    unsigned maxThreads = static_cast<unsigned>(
+        argCount(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency())));
+    for (unsigned threads = 2; threads <= maxThreads; threads *= 2) {
+        Catalog catalog;
+        CsvImporter::Stats stats;
+        Stopwatch timer;
+        CsvImporter::importFile(catalog, filename, stats, threads);
+        std::string label = "parallel x" + std::to_string(threads);
+        printRate(label.c_str(), stats.rowsImported, timer.seconds(), "rows");
+    }
+
+    std::remove(filename.c_str());
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Re-syncing a large products feed after a small change: loads a synthetic
+// feed, rewrites it with 1% of the rows changed (price or stock), then
+// compares a full CsvImporter re-import against a CsvSync delta, plus the
+// cost of re-syncing an untouched file (size/mtime skip) and a rewritten
+// but identical one (content-hash skip). "written" is the number of
+// catalog writes, measured as the change in Catalog::version().
+//
+// Usage: bench_csv_sync [rows] [threads]   (default 10,000,000 rows)
+
+#include "BenchUtil.h"
+#include "CsvImporter.h"
+#include "CsvSync.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+// Writes the same feed as writeSyntheticProductsCSV, with every 100th row's
+// stock (or, alternately, price) changed.
+static void writeChangedProductsCSV(const std::string& filename, size_t rows) {
+    std::ofstream file(filename, std::ios::binary);
+    file << "Product Name,Price,Stock\n";
+    std::string line;
+    for (size_t i = 0; i < rows; ++i) {
+        bool changed = i % 100 == 0;
+        line = syntheticProductName(i);
+        line += ',';
+        line += std::to_string(1 + (i * 7919) % 100000 / 100.0 + (changed && i % 200 == 0 ? 1.0 : 0.0));
+        line += ',';
+        line += std::to_string((i * 31) % 500 + (changed && i % 200 != 0 ? 1 : 0));
+        line += '\n';
+        file.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+}
+
+static void printSync(const char* label, const CsvSync::Stats& stats, double seconds, uint64_t written) {
+    std::printf("%-28s %8.3f s  written %9llu  (+%zu ~%zu =%zu -%zu%s)\n", label, seconds,
+                static_cast<unsigned long long>(written), stats.inserted, stats.updated, stats.unchanged,
+                stats.deleted, stats.skipped ? ", skipped" : "");
+}
+
+int main(int argc, char** argv) {
+    size_t rows = argCount(argc, argv, 1, 10000000);
+    unsigned threads = static_cast<unsigned>(
+        argCount(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency())));
+    const std::string original = "bench_sync_original.csv";
+    const std::string filename = "bench_sync_products.csv";
+    writeSyntheticProductsCSV(original, rows);
+    writeChangedProductsCSV(filename, rows);
+
+    {
+        Catalog catalog;
+        CsvImporter::Stats loaded;
+        CsvImporter::importFile(catalog, original, loaded, threads);
+        uint64_t before = catalog.version();
+        CsvImporter::Stats stats;
+        Stopwatch timer;
+        CsvImporter::importFile(catalog, filename, stats, threads);
+        double seconds = timer.seconds();
+        std::printf("%-28s %8.3f s  written %9llu\n", "full re-import", seconds,
+                    static_cast<unsigned long long>(catalog.version() - before));
+    }
+
+    // The first sync loads the original feed and records it as the
+    // baseline the changed feed is compared with.
+    Catalog catalog;
+    CsvSync sync;
+    CsvSync::Stats loaded;
+    sync.sync(catalog, original, false, loaded, threads);
+
+    auto timedSync = [&](const char* label, bool deleteMissing) {
+        CsvSync::Stats stats;
+        uint64_t before = catalog.version();
+        Stopwatch timer;
+        sync.sync(catalog, filename, deleteMissing, stats, threads);
+        printSync(label, stats, timer.seconds(), catalog.version() - before);
+    };
+    timedSync("delta sync (1% changed)", false);
+    timedSync("re-sync, file untouched", false);
+    writeChangedProductsCSV(filename, rows);
+    timedSync("re-sync, same contents", false);
+    timedSync("re-sync + delete missing", true);
+
+    {
+        ShardedCatalog sharded;
+        CsvSync shardedSync;
+        shardedSync.sync(sharded, original, false, loaded, threads);
+        CsvSync::Stats stats;
+        Stopwatch timer;
+        shardedSync.sync(sharded, filename, false, stats, threads);
+        printSync("sharded delta sync", stats, timer.seconds(), stats.inserted + stats.updated);
+    }
+
+    std::remove(original.c_str());
+    std::remove(filename.c_str());
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Fuzzy name matching latency on a large catalog: indexes synthetic
+// "Brand Adjective Noun CODE" names, then looks up names with one or two
+// random typos, reporting mean, p99 and max latency and how often the
+// intended product was among the matches. Brands are built from syllables
+// (tens of thousands of them, as in a real marketplace) and CODE is a
+// unique five-character alphanumeric model code.
+//
+// Usage: bench_fuzzy [names] [queries]   (default 5000000, 10000)
+
+#include "BenchUtil.h"
+#include "FuzzyMatcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+static const char* const SYLLABLES[] = {"ka", "lo", "mi", "ra", "ven", "tor", "bel", "zen", "qua", "dri", "sol",
+                                        "nex", "pho", "lum", "tri", "gal", "ori", "vex", "mar", "ton", "sy",
+                                        "pel", "dax", "rin", "cor", "fle", "gra", "hon", "jet", "kor", "lyn",
+                                        "myr"};
+static const char* const ADJECTIVES[] = {"Red", "Blue", "Green", "Black", "White", "Silver", "Compact",
+                                         "Portable", "Wireless", "Smart", "Classic", "Ultra", "Mini",
+                                         "Pro", "Deluxe", "Rugged", "Slim", "Heavy", "Quiet", "Fast"};
+static const char* const NOUNS[] = {"Laptop", "Phone", "Tablet", "Monitor", "Keyboard", "Mouse",
+                                    "Headphones", "Speaker", "Camera", "Charger", "Router", "Printer",
+                                    "Watch", "Drone", "Lamp", "Backpack", "Bottle", "Chair", "Desk",
+                                    "Blender", "Kettle", "Toaster", "Jacket", "Sneakers", "Guitar"};
+
+template <typename T, size_t N>
+static constexpr size_t countOf(T (&)[N]) { return N; }
+
+static uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static std::string productName(size_t i) {
+    static const char CODE_CHARS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    uint64_t h = mix(i);
+    std::string name;
+    for (int syllable = 0, count = 2 + static_cast<int>(h % 2); syllable < count; ++syllable) {
+        h /= 2;
+        name += SYLLABLES[h % countOf(SYLLABLES)];
+        h /= countOf(SYLLABLES);
+    }
+    name[0] = static_cast<char>(name[0] - 'a' + 'A');
+    name += ' ';
+    name += ADJECTIVES[h % countOf(ADJECTIVES)];
+    h /= countOf(ADJECTIVES);
+    name += ' ';
+    name += NOUNS[h % countOf(NOUNS)];
+    name += ' ';
+    // A bijection on [0, 36^5) scatters consecutive indexes across codes.
+    const uint64_t codes = 36ull * 36 * 36 * 36 * 36;
+    uint64_t code = (i * 48271ull + 12345) % codes;
+    for (int digit = 0; digit < 5; ++digit) {
+        name += CODE_CHARS[code % 36];
+        code /= 36;
+    }
+    return name;
+}
+
+// Applies `edits` random substitutions, insertions or deletions.
+static std::string withTypos(std::string name, unsigned edits, std::mt19937_64& rng) {
+    for (unsigned e = 0; e < edits; ++e) {
+        size_t pos = rng() % name.size();
+        char letter = static_cast<char>('a' + rng() % 26);
+        switch (rng() % 3) {
+            case 0: name[pos] = letter; break;
+            case 1: name.insert(name.begin() + static_cast<std::ptrdiff_t>(pos), letter); break;
+            default: name.erase(pos, 1); break;
+        }
+    }
+    return name;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argCount(argc, argv, 1, 5000000);
+    size_t queries = std::max<size_t>(1, argCount(argc, argv, 2, 10000));
+    const size_t limit = 5;
+    auto always = [](uint32_t) { return true; };
+
+    FuzzyMatcher matcher;
+    Stopwatch timer;
+    for (size_t i = 0; i < count; ++i) {
+        matcher.add(static_cast<uint32_t>(i), productName(i));
+    }
+    printRate("trigram index build", count, timer.seconds(), "names");
+
+    for (unsigned edits = 1; edits <= 2; ++edits) {
+        std::mt19937_64 rng(edits);
+        std::vector<uint32_t> targets;
+        std::vector<std::string> typed;
+        for (size_t i = 0; i < queries; ++i) {
+            targets.push_back(static_cast<uint32_t>(rng() % count));
+            typed.push_back(withTypos(productName(targets.back()), edits, rng));
+        }
+
+        std::vector<double> micros;
+        micros.reserve(queries);
+        size_t found = 0;
+        size_t results = 0;
+        for (size_t i = 0; i < queries; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            std::vector<FuzzyMatcher::Match> matches = matcher.closest(typed[i], limit, always);
+            micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+            results += matches.size();
+            found += std::any_of(matches.begin(), matches.end(),
+                                 [&](const FuzzyMatcher::Match& m) { return m.id == targets[i]; });
+        }
+        std::sort(micros.begin(), micros.end());
+        double sum = 0.0;
+        for (double m : micros) {
+            sum += m;
+        }
+        std::printf("%u typo(s): mean %7.2f us  p99 %7.2f us  max %8.2f us  found %5.1f%%  (%.1f results/query)\n",
+                    edits, sum / queries, micros[queries * 99 / 100], micros.back(), 100.0 * found / queries,
+                    static_cast<double>(results) / queries);
+    }
+    return 0;
+}
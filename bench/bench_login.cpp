@@ -0,0 +1,82 @@
+// Login throughput with a large accounts file: the original per-login
+// file scan versus CredentialStore's in-memory index.
+//
+// Usage: bench_login [accounts] [legacy logins]   (default 1,000,000 and 20)
+
+#include "BenchUtil.h"
+#include "CredentialStore.h"
+
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The pre-CredentialStore Customer::verifyCredentials body.
+static bool legacyVerify(const std::string& filename, const std::string& username,
+                         const std::string& password) {
+    std::ifstream file(filename);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string savedUsername, savedPassword;
+        std::getline(ss, savedUsername, ',');
+        std::getline(ss, savedPassword);
+        if (savedUsername == username && savedPassword == password) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static std::string userName(size_t i) { return "user" + std::to_string(i); }
+static std::string userPassword(size_t i) { return "pw" + std::to_string(i * 2654435761u % 1000003); }
+
+int main(int argc, char** argv) {
+    size_t users = argCount(argc, argv, 1, 1000000);
+    size_t legacyLogins = argCount(argc, argv, 2, 20);
+    const std::string filename = "bench_accounts.txt";
+    {
+        std::ofstream file(filename);
+        for (size_t i = 0; i < users; ++i) {
+            file << userName(i) << ',' << userPassword(i) << '\n';
+        }
+    }
+
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<size_t> pick(0, users - 1);
+
+    {
+        size_t ok = 0;
+        Stopwatch timer;
+        for (size_t n = 0; n < legacyLogins; ++n) {
+            size_t i = pick(rng);
+            ok += legacyVerify(filename, userName(i), userPassword(i));
+        }
+        printRate("legacy file scan", ok, timer.seconds(), "logins");
+    }
+    {
+        CredentialStore store(filename);
+        Stopwatch timer;
+        store.load();
+        printRate("index load", store.size(), timer.seconds(), "accounts");
+
+        size_t logins = users;
+        std::vector<std::pair<std::string, std::string>> attempts;
+        attempts.reserve(logins);
+        for (size_t n = 0; n < logins; ++n) {
+            size_t i = pick(rng);
+            attempts.emplace_back(userName(i), userPassword(i));
+        }
+        size_t ok = 0;
+        timer.reset();
+        for (const auto& [name, password] : attempts) {
+            ok += store.verify(name, password);
+        }
+        printRate("indexed verify", ok, timer.seconds(), "logins");
+    }
+
+    std::remove(filename.c_str());
+    return 0;
+}
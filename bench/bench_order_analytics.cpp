@@ -0,0 +1,91 @@
+// OrderAnalytics: cost of recording each order, latency of the top-K
+// queries against re-scanning every order for the same answer, and how
+// closely today's sketch-based top sellers match the exact ranking.
+// Product popularity is Zipf-distributed (s = 1.1), as real sales are.
+//
+// Usage: bench_order_analytics [orders] [products]   (default 1,000,000 / 100,000)
+
+#include "BenchUtil.h"
+#include "OrderAnalytics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    size_t orderCount = argCount(argc, argv, 1, 1000000);
+    size_t productCount = std::max<size_t>(10, argCount(argc, argv, 2, 100000));
+    const size_t customerCount = 50000;
+    const size_t topCount = 10;
+
+    std::vector<double> popularity(productCount);
+    double sum = 0.0;
+    for (size_t i = 0; i < productCount; ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), 1.1);
+        popularity[i] = sum;
+    }
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> uniform(0.0, sum);
+    std::vector<Order> orders;
+    orders.reserve(orderCount);
+    for (size_t i = 0; i < orderCount; ++i) {
+        LineItems items;
+        for (size_t line = 0, lines = 1 + rng() % 4; line < lines; ++line) {
+            auto pick = std::lower_bound(popularity.begin(), popularity.end(), uniform(rng));
+            uint32_t productId = static_cast<uint32_t>(std::min<size_t>(pick - popularity.begin(), productCount - 1));
+            Money price = Money::fromCents(static_cast<int64_t>(99 + productId % 5000));
+            items.push_back(LineItem{productId, static_cast<uint32_t>(1 + rng() % 3), price});
+        }
+        orders.emplace_back("customer-" + std::to_string(rng() % customerCount), std::move(items));
+    }
+
+    OrderAnalytics analytics;
+    const int64_t day = OrderAnalytics::currentDay();
+    Stopwatch timer;
+    for (const Order& order : orders) {
+        analytics.record(order, day);
+    }
+    printRate("record", orderCount, timer.seconds(), "orders");
+
+    const size_t queries = 10000;
+    size_t sink = 0;
+    timer.reset();
+    for (size_t q = 0; q < queries; ++q) {
+        sink += analytics.topProductsByUnits(topCount).size();
+        sink += analytics.topSellersToday(topCount, day).size();
+        sink += analytics.topCustomers(topCount).size();
+    }
+    double querySeconds = timer.seconds();
+    std::printf("%-28s %12.2f us per 3 top-%zu queries\n", "incremental", querySeconds / queries * 1e6, topCount);
+
+    // The pre-analytics way: aggregate every order, then rank.
+    timer.reset();
+    std::vector<int64_t> units(productCount, 0);
+    for (const Order& order : orders) {
+        for (const LineItem& item : order.getItems()) {
+            units[item.productId] += item.quantity;
+        }
+    }
+    std::vector<uint32_t> exact(productCount);
+    for (uint32_t i = 0; i < productCount; ++i) {
+        exact[i] = i;
+    }
+    std::partial_sort(exact.begin(), exact.begin() + topCount, exact.end(),
+                      [&](uint32_t a, uint32_t b) { return units[a] > units[b]; });
+    std::printf("%-28s %12.2f us per top-%zu units query\n", "re-scan", timer.seconds() * 1e6, topCount);
+
+    std::vector<OrderAnalytics::RankedProduct> sketched = analytics.topSellersToday(topCount, day);
+    size_t overlap = 0;
+    double worstError = 0.0;
+    for (const OrderAnalytics::RankedProduct& ranked : sketched) {
+        overlap += std::find(exact.begin(), exact.begin() + topCount, ranked.key) != exact.begin() + topCount;
+        worstError = std::max(worstError, static_cast<double>(ranked.count - units[ranked.key]) / units[ranked.key]);
+    }
+    std::printf("sketch top-%zu: %zu of %zu match the exact ranking, worst overcount %.4f%%\n", topCount, overlap,
+                topCount, worstError * 100.0);
+    std::printf("(checksum %zu)\n", sink);
+    return 0;
+}
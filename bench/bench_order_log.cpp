@@ -0,0 +1,73 @@
+// Durable checkout throughput through OrderLog: every order is on disk
+// before append() returns, and concurrent checkouts share fdatasyncs. Runs
+// 1 thread (one sync per order) and then `threads` threads, and replays
+// the log afterwards to check that every order came back.
+//
+// Usage: bench_order_log [threads] [orders per thread]   (default 64 x 200)
+
+#include "BenchUtil.h"
+#include "Catalog.h"
+#include "OrderLog.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv) {
+    size_t threads = argCount(argc, argv, 1, 64);
+    size_t perThread = argCount(argc, argv, 2, 200);
+    const std::string filename = "bench_orders.log";
+
+    Catalog catalog;
+    for (size_t i = 0; i < 3; ++i) {
+        std::string name = syntheticProductName(i);
+        catalog.insert(Product(name, Money::fromCents(999 + 100 * static_cast<int64_t>(i)), 1000000));
+    }
+    LineItems items;
+    for (const Product& product : catalog) {
+        items.push_back(LineItem{product.getId(), 2, product.getPrice()});
+    }
+
+    for (size_t threadCount : {size_t(1), threads}) {
+        std::remove(filename.c_str());
+        std::vector<Order> replayed;
+        OrderLog::ReplayStats stats;
+        OrderLog log(filename);
+        if (!log.open(catalog, replayed, stats)) {
+            std::printf("Failed to open %s\n", filename.c_str());
+            return 1;
+        }
+
+        std::atomic<size_t> failures{0};
+        size_t total = threadCount * perThread;
+        Stopwatch timer;
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threadCount; ++t) {
+            workers.emplace_back([&, t] {
+                for (size_t i = 0; i < perThread; ++i) {
+                    Order order("customer" + std::to_string(t), LineItems(items));
+                    failures += !log.append(order, catalog);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        double seconds = timer.seconds();
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "%zu thread(s)", threadCount);
+        printRate(label, total, seconds, "orders");
+        std::printf("%-28s %.1f orders per fdatasync, %zu failed\n", "",
+                    static_cast<double>(total) / log.batchCount(), failures.load());
+
+        OrderLog reopened(filename);
+        replayed.clear();
+        reopened.open(catalog, replayed, stats);
+        std::printf("%-28s replayed %zu of %zu orders\n", "", stats.ordersReplayed, total);
+    }
+    std::remove(filename.c_str());
+    return 0;
+}
@@ -0,0 +1,155 @@
+// Order totals in integer cents (Money) versus the old double prices:
+// per-order Order::total() over synthetic orders of 1-8 lines, a flat
+// sum of price * quantity over every line (the shape a vectorized revenue
+// report takes), and the grand total reduced forwards, backwards and in
+// parallel chunks to show which representation gives the same answer
+// regardless of summation order.
+//
+// Usage: bench_order_total [orders] [threads]   (default 2,000,000)
+
+#include "BenchUtil.h"
+#include "LineItem.h"
+#include "Money.h"
+#include "Order.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The pre-Money line item and Order::total(), kept for comparison.
+struct DoubleLineItem {
+    uint32_t productId;
+    uint32_t quantity;
+    double unitPrice;
+};
+using DoubleLineItems = SmallVector<DoubleLineItem, 8>;
+
+static double doubleTotal(const DoubleLineItems& items) {
+    double sum = 0.0;
+    for (const DoubleLineItem& item : items) {
+        sum += item.unitPrice * item.quantity;
+    }
+    return sum;
+}
+
+// Sums values[i] over [begin, end) on `threads` threads, then adds the
+// partial sums in chunk order.
+template <typename T>
+static T parallelSum(const std::vector<T>& values, unsigned threads) {
+    std::vector<T> partial(threads, T());
+    std::vector<std::thread> workers;
+    size_t chunk = (values.size() + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            size_t end = std::min(values.size(), (t + 1) * chunk);
+            for (size_t i = t * chunk; i < end; ++i) {
+                partial[t] += values[i];
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    T total = T();
+    for (const T& part : partial) {
+        total += part;
+    }
+    return total;
+}
+
+template <typename T>
+static void reportOrderIndependence(const char* label, const std::vector<T>& totals, unsigned threads,
+                                    double (*asDollars)(T)) {
+    T forward = T();
+    for (const T& total : totals) {
+        forward += total;
+    }
+    T backward = T();
+    for (auto it = totals.rbegin(); it != totals.rend(); ++it) {
+        backward += *it;
+    }
+    T parallel = parallelSum(totals, threads);
+    bool identical = std::memcmp(&forward, &backward, sizeof(T)) == 0 && std::memcmp(&forward, &parallel, sizeof(T)) == 0;
+    std::printf("%-28s forward %.6f  backward %.6f  x%u %.6f  -> %s\n", label, asDollars(forward),
+                asDollars(backward), threads, asDollars(parallel), identical ? "bit-identical" : "DIFFERENT");
+}
+
+int main(int argc, char** argv) {
+    size_t orderCount = argCount(argc, argv, 1, 2000000);
+    unsigned threads = static_cast<unsigned>(
+        argCount(argc, argv, 2, std::max(4u, std::thread::hardware_concurrency())));
+
+    std::mt19937_64 rng(7);
+    std::vector<Order> orders;
+    std::vector<DoubleLineItems> doubleOrders;
+    std::vector<int64_t> lineCents;
+    std::vector<double> linePrices;
+    std::vector<uint32_t> lineQuantities;
+    orders.reserve(orderCount);
+    doubleOrders.reserve(orderCount);
+    for (size_t i = 0; i < orderCount; ++i) {
+        LineItems items;
+        DoubleLineItems doubleItems;
+        for (size_t line = 0, lines = 1 + rng() % 8; line < lines; ++line) {
+            uint32_t productId = static_cast<uint32_t>(rng() % 100000);
+            uint32_t quantity = static_cast<uint32_t>(1 + rng() % 5);
+            Money price = Money::fromCents(static_cast<int64_t>(99 + rng() % 200000));
+            items.push_back(LineItem{productId, quantity, price});
+            doubleItems.push_back(DoubleLineItem{productId, quantity, price.toDouble()});
+            lineCents.push_back(price.inCents());
+            linePrices.push_back(price.toDouble());
+            lineQuantities.push_back(quantity);
+        }
+        orders.emplace_back("customer", std::move(items));
+        doubleOrders.push_back(std::move(doubleItems));
+    }
+    size_t lineCount = lineCents.size();
+
+    std::vector<double> doubleTotals(orderCount);
+    Stopwatch timer;
+    for (size_t i = 0; i < orderCount; ++i) {
+        doubleTotals[i] = doubleTotal(doubleOrders[i]);
+    }
+    printRate("Order total, double", orderCount, timer.seconds(), "orders");
+
+    std::vector<Money> moneyTotals(orderCount);
+    timer.reset();
+    for (size_t i = 0; i < orderCount; ++i) {
+        moneyTotals[i] = orders[i].total();
+    }
+    printRate("Order total, Money", orderCount, timer.seconds(), "orders");
+
+    const size_t repeats = 10;
+    volatile double doubleSink = 0.0;
+    timer.reset();
+    for (size_t r = 0; r < repeats; ++r) {
+        double sum = 0.0;
+        for (size_t i = 0; i < lineCount; ++i) {
+            sum += linePrices[i] * lineQuantities[i];
+        }
+        doubleSink = sum;
+    }
+    printRate("flat line sum, double", lineCount * repeats, timer.seconds(), "lines");
+
+    volatile int64_t centsSink = 0;
+    timer.reset();
+    for (size_t r = 0; r < repeats; ++r) {
+        int64_t sum = 0;
+        for (size_t i = 0; i < lineCount; ++i) {
+            sum += lineCents[i] * lineQuantities[i];
+        }
+        centsSink = sum;
+    }
+    printRate("flat line sum, cents", lineCount * repeats, timer.seconds(), "lines");
+    (void)doubleSink;
+    (void)centsSink;
+
+    reportOrderIndependence<double>("grand total, double", doubleTotals, threads, [](double v) { return v; });
+    reportOrderIndependence<Money>("grand total, Money", moneyTotals, threads,
+                                   [](Money v) { return v.toDouble(); });
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Concurrent registration throughput: one write + fdatasync per signup
+// under a global lock versus CredentialStore's group-committed log. Also
+// checks that concurrent signups for one username admit exactly one.
+//
+// Usage: bench_register [threads] [signups per thread]   (default 32 x 200)
+
+#include "BenchUtil.h"
+#include "CredentialStore.h"
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+template <typename Fn>
+static double runThreads(size_t threads, Fn fn) {
+    Stopwatch timer;
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back(fn, t);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return timer.seconds();
+}
+
+int main(int argc, char** argv) {
+    size_t threads = argCount(argc, argv, 1, 32);
+    size_t perThread = argCount(argc, argv, 2, 200);
+    const std::string filename = "bench_register_accounts.txt";
+    size_t total = threads * perThread;
+
+    {
+        std::remove(filename.c_str());
+        int fd = ::open(filename.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+        std::mutex fileMutex;
+        double seconds = runThreads(threads, [&](size_t t) {
+            for (size_t i = 0; i < perThread; ++i) {
+                std::string line = "user" + std::to_string(t) + "_" + std::to_string(i) + ",pw\n";
+                std::lock_guard<std::mutex> lock(fileMutex);
+                if (::write(fd, line.data(), line.size()) < 0 || ::fdatasync(fd) != 0) {
+                    std::perror("write");
+                }
+            }
+        });
+        ::close(fd);
+        printRate("fsync per signup", total, seconds, "signups");
+    }
+    {
+        std::remove(filename.c_str());
+        CredentialStore store(filename);
+        store.load();
+        std::atomic<size_t> registered{0};
+        double seconds = runThreads(threads, [&](size_t t) {
+            for (size_t i = 0; i < perThread; ++i) {
+                std::string name = "user" + std::to_string(t) + "_" + std::to_string(i);
+                registered += store.registerAccount(name, "pw") == RegisterResult::Registered;
+            }
+        });
+        printRate("group commit", registered.load(), seconds, "signups");
+    }
+    {
+        std::remove(filename.c_str());
+        CredentialStore store(filename);
+        store.load();
+        std::atomic<size_t> winners{0};
+        runThreads(threads, [&](size_t) {
+            winners += store.registerAccount("same_name", "pw") == RegisterResult::Registered;
+        });
+        std::printf("duplicate-name race: %zu of %zu signups succeeded\n", winners.load(), threads);
+    }
+
+    std::remove(filename.c_str());
+    return 0;
+}
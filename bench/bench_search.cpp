@@ -0,0 +1,92 @@
+// Product search latency on a large catalog: builds a ProductSearch over
+// synthetic "Brand Adjective Noun Model" names, then times prefix
+// (autocomplete) and keyword queries, reporting mean, p99 and max.
+//
+// Usage: bench_search [names] [queries]   (default 5000000, 10000)
+
+#include "BenchUtil.h"
+#include "ProductSearch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+static const char* const BRANDS[] = {"Acme", "Globex", "Initech", "Umbrella", "Stark", "Wayne", "Wonka",
+                                     "Hooli", "Vandelay", "Soylent", "Tyrell", "Cyberdyne", "Aperture",
+                                     "Massive", "Oscorp", "Gringotts"};
+static const char* const ADJECTIVES[] = {"Red", "Blue", "Green", "Black", "White", "Silver", "Compact",
+                                         "Portable", "Wireless", "Smart", "Classic", "Ultra", "Mini",
+                                         "Pro", "Deluxe", "Rugged", "Slim", "Heavy", "Quiet", "Fast"};
+static const char* const NOUNS[] = {"Laptop", "Phone", "Tablet", "Monitor", "Keyboard", "Mouse",
+                                    "Headphones", "Speaker", "Camera", "Charger", "Router", "Printer",
+                                    "Watch", "Drone", "Lamp", "Backpack", "Bottle", "Chair", "Desk",
+                                    "Blender", "Kettle", "Toaster", "Jacket", "Sneakers", "Guitar"};
+
+template <typename T, size_t N>
+static constexpr size_t countOf(T (&)[N]) { return N; }
+
+static std::string productName(size_t i) {
+    std::string name = BRANDS[i % countOf(BRANDS)];
+    name += ' ';
+    name += ADJECTIVES[(i / 7) % countOf(ADJECTIVES)];
+    name += ' ';
+    name += NOUNS[(i / 131) % countOf(NOUNS)];
+    name += " M";
+    name += std::to_string(i);
+    return name;
+}
+
+template <typename Query>
+static void timeQueries(const char* label, size_t queries, Query query) {
+    std::vector<double> micros;
+    micros.reserve(queries);
+    size_t results = 0;
+    for (size_t i = 0; i < queries; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        results += query(i);
+        micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(micros.begin(), micros.end());
+    double sum = 0.0;
+    for (double m : micros) {
+        sum += m;
+    }
+    std::printf("%-28s mean %7.2f us  p99 %7.2f us  max %8.2f us  (%.1f results/query)\n", label,
+                sum / queries, micros[queries * 99 / 100], micros.back(), static_cast<double>(results) / queries);
+}
+
+int main(int argc, char** argv) {
+    size_t count = argCount(argc, argv, 1, 5000000);
+    size_t queries = std::max<size_t>(1, argCount(argc, argv, 2, 10000));
+    const size_t limit = 10;
+    auto always = [](uint32_t) { return true; };
+
+    ProductSearch search;
+    Stopwatch timer;
+    for (size_t i = 0; i < count; ++i) {
+        search.add(static_cast<uint32_t>(i), productName(i));
+    }
+    printRate("index build (add)", count, timer.seconds(), "names");
+
+    std::mt19937_64 rng(42);
+    std::vector<std::string> prefixes;
+    std::vector<std::string> keywordQueries;
+    for (size_t i = 0; i < queries; ++i) {
+        std::string name = productName(rng() % count);
+        prefixes.push_back(name.substr(0, 3 + rng() % (name.size() - 3)));
+        size_t firstSpace = name.find(' ');
+        size_t lastSpace = name.rfind(' ');
+        // Alternate a common two-word query with a selective brand + model one.
+        keywordQueries.push_back(i % 2 ? name.substr(firstSpace + 1, lastSpace - firstSpace - 1)
+                                       : name.substr(0, firstSpace) + name.substr(lastSpace));
+    }
+
+    timeQueries("prefix search", queries,
+                [&](size_t i) { return search.prefixSearch(prefixes[i], limit, always).size(); });
+    timeQueries("keyword search", queries,
+                [&](size_t i) { return search.keywordSearch(keywordQueries[i], limit, always).size(); });
+    return 0;
+}
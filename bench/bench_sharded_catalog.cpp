@@ -0,0 +1,151 @@
+// Mixed read/write catalog load: reader threads look up random products
+// (the browse / add-to-cart path) while one admin thread keeps updating
+// prices and periodically publishes a 1000-row bulk upload. Compares a
+// Catalog behind a shared_mutex with ShardedCatalog, for 1, 2, 4, ...
+// reader threads up to the core count.
+//
+// Usage: bench_sharded_catalog [products] [seconds per run]   (default 200000, 2)
+
+#include "BenchUtil.h"
+#include "Catalog.h"
+#include "ShardedCatalog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+static constexpr size_t BULK_ROWS = 1000;
+static constexpr size_t WRITES_PER_BULK = 100;
+
+struct RunResult {
+    size_t reads = 0;
+    size_t writes = 0;
+    double seconds = 0.0;
+};
+
+// Runs `readers` threads of readOne(rng) and one thread of writeOne(rng,
+// count) for `seconds`.
+template <typename ReadFn, typename WriteFn>
+static RunResult runMixed(size_t readers, double seconds, ReadFn readOne, WriteFn writeOne) {
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> reads{0};
+    size_t writes = 0;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < readers; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937_64 rng(t + 1);
+            size_t mine = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 64; ++i) {
+                    readOne(rng);
+                }
+                mine += 64;
+            }
+            reads += mine;
+        });
+    }
+    threads.emplace_back([&] {
+        std::mt19937_64 rng(12345);
+        while (!stop.load(std::memory_order_relaxed)) {
+            writeOne(rng, writes++);
+        }
+    });
+    Stopwatch timer;
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return RunResult{reads.load(), writes, timer.seconds()};
+}
+
+static void report(const char* label, size_t readers, const RunResult& result) {
+    std::printf("%-26s readers %3zu  %14.0f reads/sec  %10.0f writes/sec\n", label, readers,
+                result.reads / result.seconds, result.writes / result.seconds);
+}
+
+int main(int argc, char** argv) {
+    size_t count = argCount(argc, argv, 1, 200000);
+    double seconds = static_cast<double>(argCount(argc, argv, 2, 2));
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < count; ++i) {
+        names.push_back(syntheticProductName(i));
+    }
+    std::vector<Product> initial;
+    initial.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        initial.emplace_back(names[i], Money::fromCents(100 + 100 * static_cast<int64_t>(i % 100)), 100);
+    }
+    auto bulkBatch = [&](std::mt19937_64& rng) {
+        std::vector<Product> batch;
+        batch.reserve(BULK_ROWS);
+        for (size_t i = 0; i < BULK_ROWS; ++i) {
+            batch.emplace_back(names[rng() % count], Money::fromCents(100 + 100 * static_cast<int64_t>(rng() % 1000)), 100);
+        }
+        return batch;
+    };
+
+    std::vector<size_t> readerCounts;
+    for (size_t readers = 1; readers < cores; readers *= 2) {
+        readerCounts.push_back(readers);
+    }
+    readerCounts.push_back(cores);
+
+    for (size_t readers : readerCounts) {
+        Catalog catalog;
+        std::shared_mutex catalogMutex;
+        for (const Product& product : initial) {
+            catalog.insertOrAssign(product);
+        }
+        RunResult locked = runMixed(readers, seconds,
+            [&](std::mt19937_64& rng) {
+                std::shared_lock<std::shared_mutex> lock(catalogMutex);
+                const Product* product = catalog.find(names[rng() % count]);
+                if (!product || product->getStock() < 0) {
+                    std::abort();
+                }
+            },
+            [&](std::mt19937_64& rng, size_t n) {
+                if (n % WRITES_PER_BULK == 0) {
+                    std::vector<Product> batch = bulkBatch(rng);
+                    std::unique_lock<std::shared_mutex> lock(catalogMutex);
+                    for (const Product& product : batch) {
+                        catalog.insertOrAssign(product);
+                    }
+                    return;
+                }
+                Product update(names[rng() % count], Money::fromCents(100 + 100 * static_cast<int64_t>(rng() % 1000)), 100);
+                std::unique_lock<std::shared_mutex> lock(catalogMutex);
+                catalog.insertOrAssign(std::move(update));
+            });
+        report("Catalog + shared_mutex", readers, locked);
+
+        ShardedCatalog sharded;
+        sharded.publish(initial);
+        RunResult rcu = runMixed(readers, seconds,
+            [&](std::mt19937_64& rng) {
+                ShardedCatalog::Reader view = sharded.read();
+                const CatalogItem* item = view.find(names[rng() % count]);
+                if (!item || item->getStock() < 0) {
+                    std::abort();
+                }
+            },
+            [&](std::mt19937_64& rng, size_t n) {
+                if (n % WRITES_PER_BULK == 0) {
+                    sharded.publish(bulkBatch(rng));
+                    return;
+                }
+                sharded.insertOrAssign(
+                    Product(names[rng() % count], Money::fromCents(100 + 100 * static_cast<int64_t>(rng() % 1000)), 100));
+            });
+        report("ShardedCatalog (epochs)", readers, rcu);
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+// Catalog cold start: parsing products.csv versus opening a binary
+// CatalogSnapshot, plus lookups served directly from the mapped snapshot.
+//
+// Usage: bench_snapshot [products]   (default 10,000,000)
+
+#include "BenchUtil.h"
+#include "CatalogSnapshot.h"
+#include "CsvImporter.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    size_t count = argCount(argc, argv, 1, 10000000);
+    const std::string csvFile = "bench_snapshot.csv";
+    const std::string snapFile = "bench_snapshot.snap";
+    writeSyntheticProductsCSV(csvFile, count);
+
+    {
+        Catalog catalog;
+        CsvImporter::Stats stats;
+        Stopwatch timer;
+        CsvImporter::importFile(catalog, csvFile, stats);
+        printRate("CSV import", stats.rowsImported, timer.seconds(), "products");
+
+        timer.reset();
+        CatalogSnapshot::write(catalog, snapFile);
+        printRate("snapshot write", catalog.size(), timer.seconds(), "products");
+    }
+
+    CatalogSnapshot snapshot;
+    Stopwatch timer;
+    bool opened = snapshot.open(snapFile);
+    double openSeconds = timer.seconds();
+    std::printf("snapshot open: %s, %zu products in %.3f ms\n", opened ? "ok" : "FAILED",
+                snapshot.size(), openSeconds * 1000.0);
+
+    std::mt19937_64 rng(11);
+    std::uniform_int_distribution<size_t> pick(0, count - 1);
+    std::vector<std::string> names;
+    for (size_t i = 0; i < 1000000; ++i) {
+        names.push_back(syntheticProductName(pick(rng)));
+    }
+    size_t found = 0;
+    timer.reset();
+    for (const std::string& name : names) {
+        found += snapshot.find(name) >= 0;
+    }
+    printRate("mapped lookups", found, timer.seconds(), "lookups");
+
+    {
+        Catalog catalog;
+        timer.reset();
+        snapshot.loadInto(catalog);
+        printRate("snapshot -> Catalog", catalog.size(), timer.seconds(), "products");
+    }
+
+    std::remove(csvFile.c_str());
+    std::remove(snapFile.c_str());
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Flash-sale contention: many threads checking out the same product at
+// once. Compares Catalog::reserveStock (lock-free CAS per line item) with
+// the same check-and-decrement done under one global mutex, and checks
+// that neither oversells.
+//
+// Usage: bench_stock_contention [threads] [attempts per thread]   (default 1000 x 1000)
+
+#include "BenchUtil.h"
+#include "Catalog.h"
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+template <typename Fn>
+static double runThreads(size_t threads, Fn fn) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            fn();
+        });
+    }
+    Stopwatch timer;
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return timer.seconds();
+}
+
+int main(int argc, char** argv) {
+    size_t threads = argCount(argc, argv, 1, 1000);
+    size_t attempts = argCount(argc, argv, 2, 1000);
+    size_t total = threads * attempts;
+    int initialStock = static_cast<int>(total / 2);  // half the attempts can succeed
+
+    {
+        Catalog catalog;
+        catalog.insert(Product("Flash Sale Item", Money::fromCents(999), initialStock));
+        uint32_t id = catalog.find("Flash Sale Item")->getId();
+        std::atomic<size_t> sold{0};
+        double seconds = runThreads(threads, [&] {
+            LineItems order;
+            order.push_back(LineItem{id, 1, Money::fromCents(999)});
+            size_t mine = 0;
+            for (size_t i = 0; i < attempts; ++i) {
+                mine += catalog.reserveStock(order) < 0;
+            }
+            sold += mine;
+        });
+        printRate("lock-free reserveStock", total, seconds, "attempts");
+        std::printf("%-28s sold %zu of %d, stock left %d\n", "", sold.load(), initialStock,
+                    catalog.find("Flash Sale Item")->getStock());
+    }
+    {
+        int stock = initialStock;
+        std::mutex stockMutex;
+        std::atomic<size_t> sold{0};
+        double seconds = runThreads(threads, [&] {
+            size_t mine = 0;
+            for (size_t i = 0; i < attempts; ++i) {
+                std::lock_guard<std::mutex> lock(stockMutex);
+                if (stock > 0) {
+                    --stock;
+                    ++mine;
+                }
+            }
+            sold += mine;
+        });
+        printRate("global mutex", total, seconds, "attempts");
+        std::printf("%-28s sold %zu of %d, stock left %d\n", "", sold.load(), initialStock, stock);
+    }
+    return 0;
+}
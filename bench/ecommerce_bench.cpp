@@ -0,0 +1,353 @@
+// Benchmark suite for the store's hot paths: CSV import and export, catalog
+// lookup, login verification, add-to-cart, checkout and browse rendering.
+// Each runs against synthetic data of every requested size (the size is
+// both the number of products and the number of user accounts), a few
+// times, and the median and best runs are reported, as a table and
+// optionally as JSON so results can be compared between releases.
+//
+// Usage: ecommerce_bench [--sizes 1000,10000,...] [--only name,...]
+//                        [--repeat N] [--json file|-] [--list]
+//
+// Sizes accept k/m suffixes ("1k", "100m"). The default is 1k,10k,100k,1m;
+// 100m products and users need roughly 20 GB of memory and disk.
+
+#include "BenchUtil.h"
+#include "Catalog.h"
+#include "CatalogPager.h"
+#include "CredentialStore.h"
+#include "CsvExporter.h"
+#include "CsvImporter.h"
+#include "Users.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Synthetic data for one size, generated once and shared by the benchmarks.
+struct Fixture {
+    size_t size;
+    std::string productsFile;
+    std::string accountsFile;
+    Catalog catalog;
+    CredentialStore accounts;
+    std::mt19937_64 rng{42};
+
+    static constexpr int STOCK = 1 << 30;  // checkouts never run a product out
+
+    explicit Fixture(size_t count)
+        : size(count),
+          productsFile("ecommerce_bench_products.csv"),
+          accountsFile("ecommerce_bench_accounts.txt"),
+          accounts(accountsFile) {
+        writeSyntheticProductsCSV(productsFile, size);
+        writeSyntheticAccounts(accountsFile, size);
+        catalog.reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            std::string name = syntheticProductName(i);
+            catalog.insert(Product(name, Money::fromCents(static_cast<int64_t>(100 + (i * 7919) % 100000)), STOCK));
+        }
+        accounts.load();
+    }
+
+    ~Fixture() {
+        std::remove(productsFile.c_str());
+        std::remove(accountsFile.c_str());
+    }
+
+    size_t randomIndex() { return static_cast<size_t>(rng() % size); }
+};
+
+// Operations completed and the time they took.
+struct Measurement {
+    size_t operations = 0;
+    double seconds = 0.0;
+};
+
+struct Benchmark {
+    const char* name;
+    const char* unit;
+    std::function<Measurement(Fixture&)> run;
+};
+
+// Keeps benchmarked results observable so they are not optimized away.
+static volatile size_t sink = 0;
+
+static const size_t LOOKUPS = 1000000;
+static const size_t CART_ADDS = 1000000;
+static const size_t CHECKOUTS = 200000;
+static const size_t PAGE_RENDERS = 200000;
+
+static std::vector<Benchmark> makeBenchmarks() {
+    static std::ostream discard(nullptr);  // customer messages go nowhere
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+    return {
+        {"csv_import", "rows",
+         [threads](Fixture& fixture) {
+             Catalog catalog;
+             CsvImporter::Stats stats;
+             Stopwatch timer;
+             CsvImporter::importFile(catalog, fixture.productsFile, stats, threads);
+             return Measurement{stats.rowsImported, timer.seconds()};
+         }},
+        {"csv_export", "rows",
+         [](Fixture& fixture) {
+             const std::string filename = "ecommerce_bench_export.csv";
+             CsvExporter exporter;
+             Stopwatch timer;
+             exporter.exportFile(fixture.catalog, filename);
+             Measurement measured{fixture.catalog.size(), timer.seconds()};
+             std::remove(filename.c_str());
+             return measured;
+         }},
+        {"catalog_lookup", "lookups",
+         [](Fixture& fixture) {
+             std::vector<std::string> names;
+             names.reserve(LOOKUPS);
+             for (size_t i = 0; i < LOOKUPS; ++i) {
+                 names.push_back(syntheticProductName(fixture.randomIndex()));
+             }
+             const Catalog& catalog = fixture.catalog;
+             size_t found = 0;
+             Stopwatch timer;
+             for (const std::string& name : names) {
+                 found += catalog.find(name) != nullptr;
+             }
+             sink = sink + found;
+             return Measurement{LOOKUPS, timer.seconds()};
+         }},
+        {"login_verify", "logins",
+         [](Fixture& fixture) {
+             std::vector<std::pair<std::string, std::string>> attempts;
+             attempts.reserve(LOOKUPS);
+             for (size_t i = 0; i < LOOKUPS; ++i) {
+                 size_t user = fixture.randomIndex();
+                 attempts.emplace_back(syntheticUserName(user), syntheticPassword(user));
+             }
+             size_t verified = 0;
+             Stopwatch timer;
+             for (const auto& [name, password] : attempts) {
+                 verified += fixture.accounts.verify(name, password);
+             }
+             sink = sink + verified;
+             return Measurement{LOOKUPS, timer.seconds()};
+         }},
+        {"add_to_cart", "adds",
+         [](Fixture& fixture) {
+             const size_t cartSize = 4;
+             std::vector<std::string> names;
+             names.reserve(CART_ADDS);
+             for (size_t i = 0; i < CART_ADDS; ++i) {
+                 names.push_back(syntheticProductName(fixture.randomIndex()));
+             }
+             Customer customer("bench", "pw");
+             customer.setOutput(discard);
+             size_t added = 0;
+             Stopwatch timer;
+             for (size_t i = 0; i < CART_ADDS; ++i) {
+                 if (i % cartSize == 0) {
+                     customer = Customer("bench", "pw");  // a fresh, empty cart
+                     customer.setOutput(discard);
+                 }
+                 added += customer.addToCart(fixture.catalog, names[i]);
+             }
+             sink = sink + added;
+             return Measurement{CART_ADDS, timer.seconds()};
+         }},
+        {"checkout", "orders",
+         [](Fixture& fixture) {
+             const size_t cartSize = 3;
+             std::vector<Order> orders;
+             orders.reserve(CHECKOUTS);
+             Customer customer("bench", "pw");
+             customer.setOutput(discard);
+             double seconds = 0.0;
+             for (size_t i = 0; i < CHECKOUTS; ++i) {
+                 for (size_t item = 0; item < cartSize; ++item) {
+                     customer.addToCart(fixture.catalog, syntheticProductName(fixture.randomIndex()));
+                 }
+                 auto start = std::chrono::steady_clock::now();
+                 customer.checkout(fixture.catalog, orders);
+                 seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+             }
+             for (const Order& order : orders) {
+                 fixture.catalog.releaseStock(order.getItems());
+             }
+             return Measurement{orders.size(), seconds};
+         }},
+        {"browse_render", "pages",
+         [](Fixture& fixture) {
+             CatalogPager pager;
+             std::vector<size_t> offsets;
+             offsets.reserve(PAGE_RENDERS);
+             for (size_t i = 0; i < PAGE_RENDERS; ++i) {
+                 offsets.push_back(fixture.randomIndex());
+             }
+             size_t bytes = 0;
+             Stopwatch timer;
+             for (size_t offset : offsets) {
+                 bytes += pager.render(fixture.catalog, offset).text.size();
+             }
+             sink = sink + bytes;
+             return Measurement{PAGE_RENDERS, timer.seconds()};
+         }},
+    };
+}
+
+struct Result {
+    std::string name;
+    const char* unit;
+    size_t size;
+    size_t operations;
+    double medianSeconds;
+    double bestSeconds;
+};
+
+// Parses "1000", "10k" or "100m".
+static bool parseSize(std::string_view text, size_t& size) {
+    size_t multiplier = 1;
+    if (!text.empty() && (text.back() == 'k' || text.back() == 'K')) {
+        multiplier = 1000;
+        text.remove_suffix(1);
+    } else if (!text.empty() && (text.back() == 'm' || text.back() == 'M')) {
+        multiplier = 1000000;
+        text.remove_suffix(1);
+    }
+    char* end = nullptr;
+    std::string digits(text);
+    size = static_cast<size_t>(std::strtoull(digits.c_str(), &end, 10)) * multiplier;
+    return !digits.empty() && *end == '\0' && size > 0;
+}
+
+static std::vector<std::string> splitList(std::string_view text) {
+    std::vector<std::string> items;
+    while (!text.empty()) {
+        size_t comma = text.find(',');
+        items.emplace_back(text.substr(0, comma));
+        text.remove_prefix(comma == std::string_view::npos ? text.size() : comma + 1);
+    }
+    return items;
+}
+
+static void writeJson(std::FILE* out, const std::vector<Result>& results, unsigned repeats) {
+    std::fprintf(out, "{\n  \"suite\": \"ecommerce_bench\",\n  \"schema\": 1,\n");
+    std::fprintf(out, "  \"timestamp\": %lld,\n", static_cast<long long>(std::time(nullptr)));
+    std::fprintf(out, "  \"compiler\": \"%s\",\n", __VERSION__);
+#ifdef NDEBUG
+    std::fprintf(out, "  \"optimized\": true,\n");
+#else
+    std::fprintf(out, "  \"optimized\": false,\n");
+#endif
+    std::fprintf(out, "  \"hardware_threads\": %u,\n  \"repeats\": %u,\n  \"results\": [",
+                 std::thread::hardware_concurrency(), repeats);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::fprintf(out,
+                     "%s\n    {\"name\": \"%s\", \"size\": %zu, \"unit\": \"%s\", \"operations\": %zu, "
+                     "\"median_seconds\": %.9f, \"best_seconds\": %.9f, \"ops_per_sec\": %.1f, \"ns_per_op\": %.2f}",
+                     i == 0 ? "" : ",", r.name.c_str(), r.size, r.unit, r.operations, r.medianSeconds,
+                     r.bestSeconds, r.operations / r.medianSeconds, r.medianSeconds * 1e9 / r.operations);
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+}
+
+static int usage() {
+    std::fprintf(stderr,
+                 "usage: ecommerce_bench [--sizes 1k,10k,...] [--only name,...] [--repeat N] [--json file|-] "
+                 "[--list]\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes{1000, 10000, 100000, 1000000};
+    std::vector<std::string> only;
+    unsigned repeats = 3;
+    std::string jsonFile;
+    std::vector<Benchmark> benchmarks = makeBenchmarks();
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--list") {
+            for (const Benchmark& benchmark : benchmarks) {
+                std::printf("%s\n", benchmark.name);
+            }
+            return 0;
+        } else if (arg == "--sizes" && hasValue) {
+            sizes.clear();
+            for (const std::string& item : splitList(argv[++i])) {
+                size_t size;
+                if (!parseSize(item, size)) {
+                    return usage();
+                }
+                sizes.push_back(size);
+            }
+        } else if (arg == "--only" && hasValue) {
+            only = splitList(argv[++i]);
+        } else if (arg == "--repeat" && hasValue) {
+            repeats = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--json" && hasValue) {
+            jsonFile = argv[++i];
+        } else {
+            return usage();
+        }
+    }
+    for (const std::string& name : only) {
+        if (std::none_of(benchmarks.begin(), benchmarks.end(),
+                         [&](const Benchmark& benchmark) { return name == benchmark.name; })) {
+            std::fprintf(stderr, "unknown benchmark: %s (see --list)\n", name.c_str());
+            return 2;
+        }
+    }
+
+    // With JSON on stdout the table goes to stderr.
+    std::FILE* table = jsonFile == "-" ? stderr : stdout;
+    std::vector<Result> results;
+    for (size_t size : sizes) {
+        Stopwatch setup;
+        auto fixture = std::make_unique<Fixture>(size);
+        std::fprintf(table, "size %zu (data generated in %.2f s)\n", size, setup.seconds());
+        for (const Benchmark& benchmark : benchmarks) {
+            if (!only.empty() && std::find(only.begin(), only.end(), benchmark.name) == only.end()) {
+                continue;
+            }
+            std::vector<Measurement> runs;
+            for (unsigned r = 0; r < repeats; ++r) {
+                runs.push_back(benchmark.run(*fixture));
+            }
+            std::sort(runs.begin(), runs.end(),
+                      [](const Measurement& a, const Measurement& b) { return a.seconds < b.seconds; });
+            const Measurement& median = runs[runs.size() / 2];
+            results.push_back(Result{benchmark.name, benchmark.unit, size, median.operations, median.seconds,
+                                     runs.front().seconds});
+            std::fprintf(table, "  %-16s %12zu %-7s median %10.4f s  -> %14.0f %s/sec  %9.1f ns/op\n",
+                         benchmark.name, median.operations, benchmark.unit, median.seconds,
+                         median.operations / median.seconds, benchmark.unit,
+                         median.seconds * 1e9 / median.operations);
+        }
+    }
+
+    if (!jsonFile.empty()) {
+        std::FILE* out = jsonFile == "-" ? stdout : std::fopen(jsonFile.c_str(), "w");
+        if (!out) {
+            std::fprintf(stderr, "cannot write %s\n", jsonFile.c_str());
+            return 1;
+        }
+        writeJson(out, results, repeats);
+        if (out != stdout) {
+            std::fclose(out);
+        }
+    }
+    return 0;
+}
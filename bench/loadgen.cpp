@@ -0,0 +1,202 @@
+// Load generator for server mode (E_Commerce_Project --server). Opens one
+// connection per client thread, registers a fresh customer on each, then
+// runs a closed loop of ADD 50% / BROWSE 20% / CHECKOUT 20% / PING 10% for
+// the given duration and reports throughput and latency percentiles.
+//
+// Usage: loadgen [port|socket path] [clients] [seconds] [products]
+//        (default 9090, 32 clients, 10 s, 100 products)
+//
+// The server's accounts file gains one "loadgen-*" account per client.
+
+#include "BenchUtil.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Blocking client for the line protocol described in Server.h.
+class Client {
+    int fd = -1;
+    std::string received;
+
+public:
+    ~Client() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    bool connect(const std::string& endpoint) {
+        bool isPort = !endpoint.empty() && endpoint.find_first_not_of("0123456789") == std::string::npos;
+        if (isPort) {
+            unsigned port;
+            auto parsed = std::from_chars(endpoint.data(), endpoint.data() + endpoint.size(), port);
+            if (parsed.ec != std::errc() || port == 0 || port > 65535) {
+                return false;
+            }
+            fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(static_cast<uint16_t>(port));
+            int on = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            return ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        }
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, endpoint.c_str(), sizeof(address.sun_path) - 1);
+        return ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    }
+
+    // Sends one request and waits for its response. Returns false on a
+    // connection error; `ok` receives whether the server answered OK.
+    bool request(const std::string& line, bool& ok) {
+        std::string message = line + "\n";
+        size_t sent = 0;
+        while (sent < message.size()) {
+            ssize_t n = ::send(fd, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+
+        char chunk[64 * 1024];
+        size_t headerEnd;
+        while ((headerEnd = received.find('\n')) == std::string::npos) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                return false;
+            }
+            received.append(chunk, static_cast<size_t>(n));
+        }
+        ok = received.compare(0, 3, "OK ") == 0;
+        size_t bodyBytes = std::strtoull(received.c_str() + (ok ? 3 : 4), nullptr, 10);
+        size_t total = headerEnd + 1 + bodyBytes;
+        while (received.size() < total) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                return false;
+            }
+            received.append(chunk, static_cast<size_t>(n));
+        }
+        received.erase(0, total);
+        return true;
+    }
+};
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+int main(int argc, char** argv) {
+    std::string endpoint = argc > 1 ? argv[1] : "9090";
+    size_t clients = argCount(argc, argv, 2, 32);
+    size_t seconds = argCount(argc, argv, 3, 10);
+    size_t products = std::max<size_t>(1, argCount(argc, argv, 4, 100));
+
+    {
+        Client admin;
+        bool ok = false;
+        if (!admin.connect(endpoint) || !admin.request("ADMIN admin,1234", ok) || !ok) {
+            std::printf("Could not log in as admin on %s\n", endpoint.c_str());
+            return 1;
+        }
+        for (size_t i = 0; i < products; ++i) {
+            admin.request("ADDPRODUCT " + syntheticProductName(i) + ",9.99,1000000000", ok);
+        }
+    }
+
+    const uint64_t runId = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::atomic<bool> go{false};
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> failedClients{0};
+    std::vector<std::vector<double>> latencies(clients);
+    std::vector<size_t> errors(clients, 0);
+    std::vector<std::thread> threads;
+
+    for (size_t c = 0; c < clients; ++c) {
+        threads.emplace_back([&, c] {
+            Client client;
+            bool ok = false;
+            std::string user = "loadgen-" + std::to_string(runId) + "-" + std::to_string(c);
+            if (!client.connect(endpoint) || !client.request("REGISTER " + user + ",pw", ok) || !ok) {
+                ++failedClients;
+                return;
+            }
+            std::mt19937_64 rng(runId + c);
+            std::vector<double>& mine = latencies[c];
+            mine.reserve(1 << 16);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            while (!stop.load(std::memory_order_relaxed)) {
+                unsigned roll = rng() % 10;
+                std::string line;
+                if (roll < 5) {
+                    line = "ADD " + syntheticProductName(rng() % products) + ",1";
+                } else if (roll < 7) {
+                    line = "BROWSE";
+                } else if (roll < 9) {
+                    line = "CHECKOUT";
+                } else {
+                    line = "PING";
+                }
+                auto start = std::chrono::steady_clock::now();
+                if (!client.request(line, ok)) {
+                    ++errors[c];
+                    return;
+                }
+                mine.push_back(std::chrono::duration<double, std::micro>(
+                                   std::chrono::steady_clock::now() - start).count());
+            }
+            client.request("QUIT", ok);
+        });
+    }
+
+    Stopwatch timer;
+    go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    stop.store(true);
+    double elapsed = timer.seconds();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<double> all;
+    size_t connectionErrors = 0;
+    for (size_t c = 0; c < clients; ++c) {
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+        connectionErrors += errors[c];
+    }
+    std::sort(all.begin(), all.end());
+
+    std::printf("%zu clients (%zu failed to start), %zu connection errors\n",
+                clients, failedClients.load(), connectionErrors);
+    printRate("requests", all.size(), elapsed, "req");
+    std::printf("latency us: p50 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+                percentile(all, 0.50), percentile(all, 0.99), percentile(all, 0.999),
+                all.empty() ? 0.0 : all.back());
+    return 0;
+}
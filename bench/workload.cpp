@@ -0,0 +1,434 @@
+// Synthetic traffic for sizing hardware. `generate` writes a script of
+// shopper sessions with Zipf-distributed product popularity; `replay` runs
+// a script headlessly against the Customer and Admin APIs (a ShardedCatalog
+// shared by every session, as in server mode) at the script's rate, or at
+// --rate, and reports HDR-style latency histograms per operation.
+//
+// Usage:
+//   workload generate <script> [--sessions N] [--products N] [--users N]
+//                     [--rate OPS] [--zipf S] [--think-ms MS] [--seed N]
+//   workload replay <script> [--threads N] [--rate OPS] [--order-log FILE]
+//
+// Script format, one operation per line in time order:
+//   # workload v1 rate=<ops/sec> products=<n> users=<n>
+//   <microseconds from start> <session> <OP> [args]
+// where OP is LOGIN user,password | REGISTER user,password | BROWSE offset |
+// NEXT | ADD product,quantity | CHECKOUT | ADMIN user,password |
+// RESTOCK product,price,stock | END.
+//
+// Most sessions log into an existing account (user0, user1, ...), browse a
+// page or two, add a few popular products and check out about 60% of the
+// time; a few register a new account, and about one in 200 is an admin
+// restocking popular products. Sessions arrive as a Poisson process sized
+// so the script averages --rate operations/sec once the arrival window is
+// long next to a session (think time defaults to 200 ms). Replay starts from `products` synthetic
+// products (Product-0 is the most popular) and `users` accounts.
+//
+// Latency is measured from each operation's scheduled time, so a driver
+// that falls behind shows it as latency instead of quietly slowing down
+// (no coordinated omission); service time alone is reported as well.
+
+#include "BenchUtil.h"
+#include "LatencyHistogram.h"
+#include "OrderAnalytics.h"
+#include "OrderLog.h"
+#include "ShardedCatalog.h"
+#include "Users.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class Kind { Login, Register, Browse, Next, Add, Checkout, Admin, Restock, End, COUNT };
+
+static const char* const KIND_NAMES[] = {"LOGIN", "REGISTER", "BROWSE", "NEXT", "ADD",
+                                         "CHECKOUT", "ADMIN", "RESTOCK", "END"};
+static const size_t KINDS = static_cast<size_t>(Kind::COUNT);
+static const int INITIAL_STOCK = 10000;
+
+// "--name value" pairs after the positional arguments.
+static std::map<std::string, std::string> parseOptions(int argc, char** argv, int first) {
+    std::map<std::string, std::string> options;
+    for (int i = first; i + 1 < argc; i += 2) {
+        options[argv[i]] = argv[i + 1];
+    }
+    return options;
+}
+
+static double option(const std::map<std::string, std::string>& options, const char* name, double fallback) {
+    auto found = options.find(name);
+    return found == options.end() ? fallback : std::strtod(found->second.c_str(), nullptr);
+}
+
+// ---- generate ------------------------------------------------------------
+
+struct ScriptLine {
+    uint64_t atMicros;
+    uint32_t session;
+    std::string text;
+};
+
+static int generate(const std::string& scriptFile, const std::map<std::string, std::string>& options) {
+    size_t sessions = static_cast<size_t>(option(options, "--sessions", 100000));
+    size_t products = std::max<size_t>(1, static_cast<size_t>(option(options, "--products", 100000)));
+    size_t users = std::max<size_t>(1, static_cast<size_t>(option(options, "--users", 100000)));
+    double rate = option(options, "--rate", 20000);
+    double zipf = option(options, "--zipf", 1.0);
+    double thinkMs = option(options, "--think-ms", 200);
+    std::mt19937_64 rng(static_cast<uint64_t>(option(options, "--seed", 1)));
+
+    std::vector<double> popularity(products);
+    double sum = 0.0;
+    for (size_t i = 0; i < products; ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), zipf);
+        popularity[i] = sum;
+    }
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::exponential_distribution<double> think(1.0 / (thinkMs * 1000.0));
+    auto popularProduct = [&] {
+        size_t rank = std::lower_bound(popularity.begin(), popularity.end(), uniform(rng) * sum) - popularity.begin();
+        return syntheticProductName(std::min(rank, products - 1));
+    };
+    auto chance = [&](double p) { return uniform(rng) < p; };
+
+    // Each session's operations with offsets from its start; sessions are
+    // then spread uniformly (a Poisson arrival process) over the duration
+    // that gives the target rate.
+    std::vector<ScriptLine> lines;
+    std::vector<size_t> sessionStart(sessions + 1, 0);
+    for (uint32_t session = 0; session < sessions; ++session) {
+        sessionStart[session] = lines.size();
+        double offset = 0.0;
+        auto add = [&](std::string text) {
+            lines.push_back(ScriptLine{static_cast<uint64_t>(offset), session, std::move(text)});
+            offset += think(rng);
+        };
+        if (chance(0.005)) {
+            add("ADMIN admin,1234");
+            for (int restocks = 1 + static_cast<int>(rng() % 3); restocks > 0; --restocks) {
+                Money price = Money::fromCents(static_cast<int64_t>(100 + rng() % 100000));
+                add("RESTOCK " + popularProduct() + "," + price.toString() + "," + std::to_string(INITIAL_STOCK));
+            }
+        } else {
+            size_t user = rng() % users;
+            if (chance(0.03)) {
+                add("REGISTER new-" + std::to_string(session) + "-" + std::to_string(rng() % 1000000) + ",pw");
+            } else {
+                add("LOGIN " + syntheticUserName(user) + "," + syntheticPassword(user));
+            }
+            size_t pages = chance(0.8) ? 1 + rng() % 3 : 0;
+            for (size_t page = 0; page < pages; ++page) {
+                if (page == 0) {
+                    add("BROWSE " + std::to_string(chance(0.7) ? 0 : rng() % products));
+                } else {
+                    add("NEXT");
+                }
+            }
+            size_t adds = rng() % 7;
+            for (size_t i = 0; i < adds; ++i) {
+                add("ADD " + popularProduct() + "," + std::to_string(1 + rng() % 2));
+            }
+            if (adds > 0 && chance(0.6)) {
+                add("CHECKOUT");
+            }
+        }
+        add("END");
+    }
+    sessionStart[sessions] = lines.size();
+
+    double durationMicros = lines.size() / std::max(rate, 1e-9) * 1e6;
+    std::uniform_real_distribution<double> arrival(0.0, durationMicros);
+    for (uint32_t session = 0; session < sessions; ++session) {
+        uint64_t start = static_cast<uint64_t>(arrival(rng));
+        for (size_t i = sessionStart[session]; i < sessionStart[session + 1]; ++i) {
+            lines[i].atMicros += start;
+        }
+    }
+    std::stable_sort(lines.begin(), lines.end(),
+                     [](const ScriptLine& a, const ScriptLine& b) { return a.atMicros < b.atMicros; });
+
+    std::ofstream out(scriptFile, std::ios::binary);
+    out << "# workload v1 rate=" << rate << " products=" << products << " users=" << users << "\n";
+    for (const ScriptLine& line : lines) {
+        out << line.atMicros << ' ' << line.session << ' ' << line.text << '\n';
+    }
+    if (!out) {
+        std::printf("Failed to write %s\n", scriptFile.c_str());
+        return 1;
+    }
+    std::printf("%zu sessions arriving over %.1f s (%.0f ops/sec), %zu operations up to %.1f s, written to %s\n",
+                sessions, durationMicros / 1e6, rate, lines.size(),
+                lines.empty() ? 0.0 : lines.back().atMicros / 1e6, scriptFile.c_str());
+    return 0;
+}
+
+// ---- replay --------------------------------------------------------------
+
+struct Operation {
+    uint64_t atMicros;
+    uint32_t session;
+    Kind kind;
+    std::string name;    // user or product
+    std::string secret;  // password
+    uint64_t number = 0;  // offset or quantity
+    Money price;
+    int stock = 0;
+};
+
+static bool parseOperation(const std::string& line, Operation& op) {
+    std::istringstream in(line);
+    std::string kind, args;
+    if (!(in >> op.atMicros >> op.session >> kind)) {
+        return false;
+    }
+    std::getline(in >> std::ws, args);
+    auto found = std::find(std::begin(KIND_NAMES), std::end(KIND_NAMES), kind);
+    if (found == std::end(KIND_NAMES)) {
+        return false;
+    }
+    op.kind = static_cast<Kind>(found - std::begin(KIND_NAMES));
+    size_t comma = args.find(',');
+    switch (op.kind) {
+        case Kind::Login:
+        case Kind::Register:
+        case Kind::Admin:
+            op.name = args.substr(0, comma);
+            op.secret = comma == std::string::npos ? "" : args.substr(comma + 1);
+            return comma != std::string::npos;
+        case Kind::Browse:
+            op.number = std::strtoull(args.c_str(), nullptr, 10);
+            return true;
+        case Kind::Add:
+            op.name = args.substr(0, comma);
+            op.number = comma == std::string::npos ? 0 : std::strtoull(args.c_str() + comma + 1, nullptr, 10);
+            return comma != std::string::npos && op.number > 0;
+        case Kind::Restock: {
+            size_t second = comma == std::string::npos ? comma : args.find(',', comma + 1);
+            if (second == std::string::npos) {
+                return false;
+            }
+            op.name = args.substr(0, comma);
+            op.stock = std::atoi(args.c_str() + second + 1);
+            return Money::parse(std::string_view(args).substr(comma + 1, second - comma - 1), op.price);
+        }
+        default:
+            return true;
+    }
+}
+
+// One replay thread: the sessions whose number maps to it, run in order.
+struct Worker {
+    std::vector<Operation> operations;
+    std::array<LatencyHistogram, KINDS> latency;
+    std::array<uint64_t, KINDS> failures{};
+    LatencyHistogram service;
+    uint64_t maxLagNanos = 0;
+};
+
+struct Session {
+    Customer customer{"", ""};
+    Admin admin{"", ""};
+};
+
+static int replay(const std::string& scriptFile, const std::map<std::string, std::string>& options) {
+    std::ifstream script(scriptFile);
+    std::string header;
+    double scriptRate = 0;
+    size_t products = 0, users = 0;
+    if (!std::getline(script, header) ||
+        std::sscanf(header.c_str(), "# workload v1 rate=%lf products=%zu users=%zu", &scriptRate, &products,
+                    &users) != 3) {
+        std::printf("%s is not a workload script\n", scriptFile.c_str());
+        return 1;
+    }
+    unsigned threads = static_cast<unsigned>(
+        option(options, "--threads", std::max(1u, std::thread::hardware_concurrency())));
+    threads = std::max(1u, threads);
+    double rate = option(options, "--rate", scriptRate);
+    double timeScale = scriptRate / std::max(rate, 1e-9);
+
+    std::vector<Worker> workers(threads);
+    size_t total = 0, badLines = 0;
+    uint64_t lastMicros = 0;
+    for (std::string line; std::getline(script, line);) {
+        Operation op;
+        if (!parseOperation(line, op)) {
+            ++badLines;
+            continue;
+        }
+        lastMicros = std::max(lastMicros, op.atMicros);
+        workers[op.session % threads].operations.push_back(std::move(op));
+        ++total;
+    }
+
+    ShardedCatalog catalog;
+    {
+        std::vector<Product> initial;
+        initial.reserve(products);
+        std::vector<std::string> names;
+        names.reserve(products);
+        for (size_t i = 0; i < products; ++i) {
+            names.push_back(syntheticProductName(i));
+            initial.emplace_back(names.back(), Money::fromCents(static_cast<int64_t>(100 + (i * 7919) % 100000)),
+                                 INITIAL_STOCK);
+        }
+        catalog.publish(initial);
+    }
+    const std::string accountsFile = "workload_accounts.txt";
+    writeSyntheticAccounts(accountsFile, users);
+    CredentialStore credentials(accountsFile);
+    credentials.load();
+
+    std::string orderLogFile = options.count("--order-log") ? options.at("--order-log") : "";
+    OrderLog orderLog(orderLogFile);
+    if (!orderLogFile.empty()) {
+        Catalog replayCatalog;
+        std::vector<Order> previous;
+        OrderLog::ReplayStats replayStats;
+        if (!orderLog.open(replayCatalog, previous, replayStats)) {
+            std::printf("Failed to open order log %s\n", orderLogFile.c_str());
+            return 1;
+        }
+    }
+    OrderAnalytics analytics;
+    const Admin storeAdmin("admin", "1234");
+
+    std::printf("replaying %zu operations (%zu unreadable lines skipped) on %u threads at %.0f ops/sec\n", total,
+                badLines, threads, rate);
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now() + std::chrono::milliseconds(100);
+    std::vector<std::thread> running;
+    std::vector<size_t> placedOrders(threads, 0);
+    for (unsigned t = 0; t < threads; ++t) {
+        running.emplace_back([&, t] {
+            Worker& worker = workers[t];
+            std::ostream discard(nullptr);  // shopper messages go nowhere
+            std::unordered_map<uint32_t, Session> sessions;
+            std::vector<Order> orders;
+            for (const Operation& op : worker.operations) {
+                Clock::time_point scheduled =
+                    start + std::chrono::nanoseconds(static_cast<int64_t>(op.atMicros * 1000.0 * timeScale));
+                if (Clock::now() < scheduled) {
+                    std::this_thread::sleep_until(scheduled);
+                }
+                Clock::time_point began = Clock::now();
+                Session& session = sessions[op.session];
+                bool ok = true;
+                switch (op.kind) {
+                    case Kind::Login:
+                        session.customer = Customer(op.name, op.secret);
+                        session.customer.setOutput(discard);
+                        ok = session.customer.verifyCredentials(credentials);
+                        break;
+                    case Kind::Register:
+                        session.customer = Customer(op.name, op.secret);
+                        session.customer.setOutput(discard);
+                        ok = session.customer.registerUser(credentials);
+                        break;
+                    case Kind::Browse:
+                        session.customer.browseProducts(catalog.read(), op.number);
+                        break;
+                    case Kind::Next:
+                        session.customer.browseNextPage(catalog.read());
+                        break;
+                    case Kind::Add:
+                        ok = session.customer.addToCart(catalog.read(), op.name, static_cast<uint32_t>(op.number));
+                        break;
+                    case Kind::Checkout: {
+                        size_t before = orders.size();
+                        ShardedCatalog::Reader view = catalog.read();
+                        session.customer.checkout(view, orders, orderLog.isOpen() ? &orderLog : nullptr, &analytics);
+                        ok = orders.size() > before;
+                        break;
+                    }
+                    case Kind::Admin:
+                        session.admin = Admin(op.name, op.secret);
+                        session.admin.setOutput(discard);
+                        ok = op.name == storeAdmin.getUsername() && op.secret == storeAdmin.getPassword();
+                        break;
+                    case Kind::Restock:
+                        session.admin.addProduct(catalog, Product(op.name, op.price, op.stock));
+                        break;
+                    case Kind::End:
+                        sessions.erase(op.session);
+                        break;
+                    case Kind::COUNT:
+                        break;
+                }
+                Clock::time_point done = Clock::now();
+                uint64_t latency = static_cast<uint64_t>(std::chrono::nanoseconds(done - scheduled).count());
+                uint64_t service = static_cast<uint64_t>(std::chrono::nanoseconds(done - began).count());
+                size_t kind = static_cast<size_t>(op.kind);
+                worker.latency[kind].record(latency);
+                worker.service.record(service);
+                worker.failures[kind] += !ok;
+                worker.maxLagNanos = std::max(worker.maxLagNanos, latency - std::min(latency, service));
+            }
+            placedOrders[t] = orders.size();
+        });
+    }
+    for (std::thread& thread : running) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    std::remove(accountsFile.c_str());
+
+    std::array<LatencyHistogram, KINDS> latency;
+    std::array<uint64_t, KINDS> failures{};
+    LatencyHistogram service;
+    uint64_t maxLagNanos = 0;
+    for (const Worker& worker : workers) {
+        for (size_t kind = 0; kind < KINDS; ++kind) {
+            latency[kind].merge(worker.latency[kind]);
+            failures[kind] += worker.failures[kind];
+        }
+        service.merge(worker.service);
+        maxLagNanos = std::max(maxLagNanos, worker.maxLagNanos);
+    }
+    size_t placed = 0;
+    for (size_t count : placedOrders) {
+        placed += count;
+    }
+
+    std::printf("%zu operations in %.2f s (scheduled over %.2f s) -> %.0f ops/sec achieved; %zu orders placed; "
+                "driver at most %.2f ms behind schedule\n",
+                total, elapsed, lastMicros * timeScale / 1e6, total / elapsed, placed, maxLagNanos / 1e6);
+    std::printf("%-9s %10s %8s %10s %10s %10s %10s %10s   (latency in us)\n", "op", "count", "failed", "p50", "p90",
+                "p99", "p99.9", "max");
+    auto row = [](const char* name, const LatencyHistogram& h, uint64_t failed) {
+        std::printf("%-9s %10llu %8llu %10.1f %10.1f %10.1f %10.1f %10.1f\n", name,
+                    static_cast<unsigned long long>(h.count()), static_cast<unsigned long long>(failed),
+                    h.percentile(0.50) / 1e3, h.percentile(0.90) / 1e3, h.percentile(0.99) / 1e3,
+                    h.percentile(0.999) / 1e3, h.max() / 1e3);
+    };
+    for (size_t kind = 0; kind < KINDS; ++kind) {
+        if (latency[kind].count() > 0) {
+            row(KIND_NAMES[kind], latency[kind], failures[kind]);
+        }
+    }
+    row("(service)", service, 0);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::string mode = argc > 1 ? argv[1] : "";
+    if (argc < 3 || (mode != "generate" && mode != "replay")) {
+        std::printf("usage: workload generate <script> [--sessions N] [--products N] [--users N] [--rate OPS]\n"
+                    "                         [--zipf S] [--think-ms MS] [--seed N]\n"
+                    "       workload replay <script> [--threads N] [--rate OPS] [--order-log FILE]\n");
+        return 2;
+    }
+    std::map<std::string, std::string> options = parseOptions(argc, argv, 3);
+    return mode == "generate" ? generate(argv[2], options) : replay(argv[2], options);
+}
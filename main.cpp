@@ -1,9 +1,19 @@
 #include <iostream>
 #include <vector>
-#include <fstream>
-#include <sstream>
 #include <string>
 #include <limits>
+#include <memory>
+#include "Catalog.h"
+#include "ColumnarCatalog.h"
+#include "CredentialStore.h"
+#include "FuzzyMatcher.h"
+#include "Order.h"
+#include "OrderAnalytics.h"
+#include "OrderLog.h"
+#include "ProductSearch.h"
+#include "Server.h"
+#include "Users.h"
+#include <unistd.h>
 using namespace std;
 
 // Function to clear input buffer
@@ -11,271 +21,97 @@ void clearInputBuffer() {
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
 }
 
-
-// Product Class
-class Product {
-    string name;
-    double price;
-    int stock;
-
-public:
-    Product(string pname = "", double pprice = 0.0, int pstock = 0)
-        : name(pname), price(pprice), stock(pstock) {}
-
-    string getName() const { return name; }
-    double getPrice() const { return price; }
-    int getStock() const { return stock; }
-
-    void displayProduct() const {
-        cout << "Product: " << name << ", Price: $" << price
-             << ", Stock: " << stock << endl;
-    }
-
-    void reduceStock() {
-        if (stock > 0) {
-            stock--;
-        }
-    }
-
-    // Getter for saving products to CSV
-    string toCSV() const {
-        return name + "," + to_string(price) + "," + to_string(stock);
-    }
-};
-
-// Order Class
-class Order {
-    string customerName;
-    vector<string> products;
-
-public:
-    Order(string cname) : customerName(cname) {}
-
-    void addProduct(string product) {
-        products.push_back(product);
-    }
-
-    void displayOrder() const {
-        cout << "Order for " << customerName << ":\n";
-        for (const string& product : products) {
-            cout << "- " << product << endl;
-        }
-    }
-};
-
-// Base User Class
-class User {
-protected:
-    string username;
-    string password;
-
-public:
-    User(string uname = "", string pass = "") : username(uname), password(pass) {}
-    virtual void login() = 0; // Pure virtual function for role-specific login
-
-    string getUsername() const { return username; }
-    string getPassword() const { return password; }
-    virtual void saveCredentials(const string& filename) const {
-        ofstream file(filename, ios::app);
-        if (!file.is_open()) {
-            cout << "Failed to open file for saving user credentials.\n";
-            return;
-        }
-        file << username << "," << password << endl;
-        file.close();
-    }
-};
-
-// Admin Class
-class Admin : public User {
-public:
-    Admin(string uname, string pass) : User(uname, pass) {}
-
-    void login() override {
-        cout << "Admin login successful!\n";
-    }
-
-    void uploadProductsFromCSV(vector<Product>& catalog, const string& filename) {
-        ifstream file(filename);
-        if (!file.is_open()) {
-            cout << "Failed to open CSV file: " << filename << "\n";
-            return;
-        }
-
-        string line, name;
-        double price;
-        int stock;
-
-        while (getline(file, line)) {
-            stringstream ss(line);
-            getline(ss, name, ',');
-            if (!(ss >> price)) {
-                cout << "Invalid format for price in line: " << line << "\n";
-                continue;
-            }
-            ss.ignore(); // Ignore the comma
-            if (!(ss >> stock)) {
-                cout << "Invalid format for stock in line: " << line << "\n";
-                continue;
-            }
-
-            catalog.push_back(Product(name, price, stock));
-        }
-
-        file.close();
-        cout << "Products uploaded successfully from " << filename << "!\n";
-    }
-
-    // Save the product catalog to CSV
-    void saveProductsToCSV(const vector<Product>& catalog, const string& filename) {
-        ofstream file(filename);
-        if (!file.is_open()) {
-            cout << "Failed to open CSV file: " << filename << "\n";
-            return;
-        }
-
-        for (const auto& product : catalog) {
-            file << product.toCSV() << endl;
-        }
-
-        file.close();
-        cout << "Product catalog saved to " << filename << "!\n";
-    }
-
-    void addProduct(vector<Product>& catalog) {
-        string name;
-        double price;
-        int stock;
-        cout << "Enter product name: ";
-        getline(cin, name);
-        cout << "Enter product price: ";
-        cin >> price;
-        cout << "Enter product stock: ";
-        cin >> stock;
-        clearInputBuffer();
-
-        catalog.push_back(Product(name, price, stock));
-        cout << "Product added successfully.\n";
+// Serves the catalog to network clients until SIGINT/SIGTERM.
+int runServer(const string& endpoint, const Catalog& initialProducts, CredentialStore& credentials,
+              vector<Order>& orders, OrderLog* orderLog, OrderAnalytics& analytics, const string& productCSVFile,
+              bool watchCSV, shared_ptr<CsvSync> productSync) {
+    ShardedCatalog catalog;
+    // Keep the ids: restored orders and analytics refer to products by them.
+    catalog.publishWithIds(initialProducts);
+    Server::Config config;
+    config.endpoint = endpoint;
+    config.productCSVFile = productCSVFile;
+    config.watchProductCSV = watchCSV;
+    Server server(config, catalog, credentials, orders, orderLog, &analytics, std::move(productSync));
+    if (!server.start()) {
+        cout << "Failed to listen on " << endpoint << "\n";
+        return 1;
     }
+    server.stopOnSignals();
+    cout << "Serving on " << endpoint << " (Ctrl+C to stop)\n";
+    server.run();
+    cout << "Server stopped. Orders placed: " << orders.size() << "\n";
+    return 0;
+}
 
-private:
-    // Helper function to clear the input buffer
-    void clearInputBuffer() {
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    }
-};
-
-// Customer Class
-class Customer : public User {
-    vector<string> cart;
-    vector<string> orderHistory;
-
-public:
-    Customer(string uname, string pass) : User(uname, pass) {}
+// Main Function
+// Interactive menu by default; `--server [port|socket path] [--watch]` serves
+// the same operations to many clients at once instead, reloading
+// products.csv whenever it changes with --watch.
+int main(int argc, char** argv) {
+    Catalog catalog;
+    ColumnarCatalog catalogColumns;
+    ProductSearch productSearch;
+    FuzzyMatcher productMatcher;
+    vector<Order> orders;
+    OrderAnalytics analytics;
+    Admin admin("admin", "1234");
+    Customer customer("john_doe", "password");
 
-    void login() override {
-        cout << "Customer login successful!\n";
-    }
+    bool adminLoggedIn = false;
+    bool customerLoggedIn = false;
+    bool running = true;
+    const string credentialsFile = "accounts.txt";
+    const string productCSVFile = "products.csv";
+    const string productSnapshotFile = "products.snap";
+    const string orderLogFile = "orders.log";
 
-    void browseProducts(const vector<Product>& catalog) {
-        cout << "Product Catalog:\n";
-        for (const auto& product : catalog) {
-            product.displayProduct();
-        }
+    CredentialStore credentials(credentialsFile);
+    if (!credentials.load()) {
+        cout << "Failed to open credentials file: " << credentialsFile << "\n";
     }
 
-    void addToCart(string product) {
-        cart.push_back(product);
-        cout << product << " added to cart!\n";
+    // The order log records products by name, so the catalog has to be
+    // loaded before replaying it; otherwise every restored line item (and
+    // its analytics) would lose its product.
+    // The startup load and every later sync (menu uploads, or the server's
+    // sessions and watcher) share one CsvSync, so its feed baselines carry
+    // over; publishWithIds keeps them valid for the server's catalog.
+    auto productSync = make_shared<CsvSync>();
+    admin.shareProductSync(productSync);
+    if (::access(productCSVFile.c_str(), F_OK) == 0) {
+        admin.uploadProductsFromCSV(catalog, productCSVFile);
     }
 
-    void checkout(vector<Order>& orders) {
-        if (cart.empty()) {
-            cout << "Your cart is empty!\n";
-            return;
+    OrderLog orderLog(orderLogFile);
+    OrderLog::ReplayStats replay;
+    if (orderLog.open(catalog, orders, replay)) {
+        if (replay.ordersReplayed > 0) {
+            cout << replay.ordersReplayed << " orders restored from " << orderLogFile << "\n";
         }
-
-        Order newOrder(username);
-        for (const auto& product : cart) {
-            newOrder.addProduct(product);
+        if (replay.unknownProducts > 0) {
+            cout << replay.unknownProducts << " restored order lines name products missing from "
+                 << productCSVFile << ".\n";
         }
-        orders.push_back(newOrder);
-        cart.clear();
-        cout << "Order placed successfully!\n";
-    }
-
-    void saveAccountToFile(const string& filename) {
-        ofstream file(filename, ios::app);
-        if (!file.is_open()) {
-            cout << "Failed to open file for saving user account: " << filename << "\n";
-            return;
+        if (replay.bytesDiscarded > 0) {
+            cout << "Discarded " << replay.bytesDiscarded << " bytes of incomplete order records.\n";
         }
-
-        file << username << "," << password << endl;
-        file.close();
-        cout << "Account saved to " << filename << "!\n";
+    } else {
+        cout << "Failed to open order log: " << orderLogFile << "; orders will not be saved.\n";
     }
-
-    bool verifyCredentials(const string& filename) {
-        ifstream file(filename);
-        if (!file.is_open()) {
-            cout << "Failed to open credentials file: " << filename << "\n";
-            return false;
-        }
-
-        string line;
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string savedUsername, savedPassword;
-            getline(ss, savedUsername, ',');
-            getline(ss, savedPassword);
-
-            if (savedUsername == username && savedPassword == password) {
-                return true;
-            }
-        }
-
-        return false;
+    OrderLog* durableOrders = orderLog.isOpen() ? &orderLog : nullptr;
+    // Per-product totals are keyed by the ids replay resolved against the
+    // catalog loaded above.
+    for (const Order& order : orders) {
+        analytics.restore(order);
     }
 
-    bool registerUser(const string& filename) {
-        ifstream file(filename);
-        if (!file.is_open()) {
-            cout << "Failed to open credentials file: " << filename << "\n";
-            return false;
-        }
-
-        string line;
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string savedUsername;
-            getline(ss, savedUsername, ',');
-
-            if (savedUsername == username) {
-                cout << "Username already exists! Please try again with a different username.\n";
-                return false;
-            }
-        }
-
-        file.close();
-        saveAccountToFile(filename);
-        cout << "Registration successful!\n";
-        return true;
+    if (argc > 1 && string(argv[1]) == "--server") {
+        bool watchCSV = argc > 2 && string(argv[argc - 1]) == "--watch";
+        int endpointArgs = argc - (watchCSV ? 1 : 0);
+        return runServer(endpointArgs > 2 ? argv[2] : "9090", catalog, credentials, orders, durableOrders,
+                         analytics, productCSVFile, watchCSV, productSync);
     }
-};
-
-// Main Function
-int main() {
-    vector<Product> catalog;
-    vector<Order> orders;
-    Admin admin("admin", "1234");
-    Customer customer("john_doe", "password");
-
-    bool adminLoggedIn = false;
-    bool customerLoggedIn = false;
-    bool running = true;
-    const string credentialsFile = "accounts.txt";
-    const string productCSVFile = "products.csv";
 
     while (running) {
         cout << "\nE-Commerce System Menu:\n";
@@ -313,7 +149,7 @@ int main() {
                     getline(cin, password);
                     customer = Customer(username, password);
 
-                    if (customer.verifyCredentials(credentialsFile)) {
+                    if (customer.verifyCredentials(credentials)) {
                         customer.login();
                         customerLoggedIn = true;
                     } else {
@@ -329,7 +165,7 @@ int main() {
                     getline(cin, password);
                     customer = Customer(username, password);
 
-                    if (!customer.registerUser(credentialsFile)) {
+                    if (!customer.registerUser(credentials)) {
                         cout << "Registration failed.\n";
                     } else {
                         customerLoggedIn = true;
@@ -351,7 +187,12 @@ int main() {
                 cout << "1. Add Product\n";
                 cout << "2. Upload Products from CSV\n";
                 cout << "3. Save Product Catalog to CSV\n";
-                cout << "4. Log Out (Admin)\n";
+                cout << "4. Save Product Catalog Snapshot\n";
+                cout << "5. Load Product Catalog Snapshot\n";
+                cout << "6. View Inventory Report\n";
+                cout << "7. View Sales Report\n";
+                cout << "8. Check Out an Order Batch\n";
+                cout << "9. Log Out (Admin)\n";
                 cout << "Enter your choice: ";
 
                 int choice;
@@ -362,13 +203,36 @@ int main() {
                     case 1:
                         admin.addProduct(catalog);
                         break;
-                    case 2:
-                        admin.uploadProductsFromCSV(catalog, productCSVFile);
+                    case 2: {
+                        string answer;
+                        cout << "Also remove products that are not in the file? (y/n): ";
+                        getline(cin, answer);
+                        admin.uploadProductsFromCSV(catalog, productCSVFile, answer == "y" || answer == "Y");
                         break;
+                    }
                     case 3:
                         admin.saveProductsToCSV(catalog, productCSVFile);
                         break;
                     case 4:
+                        admin.saveProductsToSnapshot(catalog, productSnapshotFile);
+                        break;
+                    case 5:
+                        admin.loadProductsFromSnapshot(catalog, productSnapshotFile);
+                        break;
+                    case 6:
+                        admin.showInventoryReport(catalog, catalogColumns);
+                        break;
+                    case 7:
+                        admin.showSalesReport(catalog, analytics);
+                        break;
+                    case 8: {
+                        string batchFile;
+                        cout << "Enter order batch file: ";
+                        getline(cin, batchFile);
+                        admin.importOrderBatch(catalog, batchFile, orders, durableOrders, &analytics);
+                        break;
+                    }
+                    case 9:
                         adminLoggedIn = false;
                         cout << "Admin logged out.\n";
                         break;
@@ -381,9 +245,11 @@ int main() {
             if (customerLoggedIn) {
                 cout << "\nCustomer Menu:\n";
                 cout << "1. Browse Products\n";
-                cout << "2. Add to Cart\n";
-                cout << "3. Checkout\n";
-                cout << "4. Log Out (Customer)\n";
+                cout << "2. Filter Products by Price and Stock\n";
+                cout << "3. Search Products\n";
+                cout << "4. Add to Cart\n";
+                cout << "5. Checkout\n";
+                cout << "6. Log Out (Customer)\n";
                 cout << "Enter your choice: ";
 
                 int choice;
@@ -391,20 +257,67 @@ int main() {
                 clearInputBuffer();
 
                 switch (choice) {
-                    case 1:
-                        customer.browseProducts(catalog);
+                    case 1: {
+                        bool more = customer.browseProducts(catalog);
+                        string answer;
+                        while (more) {
+                            cout << "Press Enter for the next page, or q to stop: ";
+                            if (!getline(cin, answer) || answer == "q") {
+                                break;
+                            }
+                            more = customer.browseNextPage(catalog);
+                        }
                         break;
+                    }
                     case 2: {
+                        Money minPrice, maxPrice;
+                        int minStock;
+                        cout << "Enter minimum price: ";
+                        cin >> minPrice;
+                        cout << "Enter maximum price: ";
+                        cin >> maxPrice;
+                        cout << "Enter minimum stock: ";
+                        cin >> minStock;
+                        clearInputBuffer();
+                        customer.filterProducts(catalog, catalogColumns, minPrice, maxPrice, minStock);
+                        break;
+                    }
+                    case 3: {
+                        string query;
+                        cout << "Enter a name prefix or keywords: ";
+                        getline(cin, query);
+                        customer.searchProducts(catalog, productSearch, query);
+                        break;
+                    }
+                    case 4: {
                         string productName;
+                        uint32_t quantity;
                         cout << "Enter product name to add to cart: ";
                         getline(cin, productName);
-                        customer.addToCart(productName);
+                        if (!catalog.contains(productName)) {
+                            string suggestion = customer.suggestProduct(catalog, productMatcher, productName);
+                            if (suggestion.empty()) {
+                                break;
+                            }
+                            string answer;
+                            cout << "Did you mean \"" << suggestion << "\"? (y/n): ";
+                            getline(cin, answer);
+                            if (answer != "y" && answer != "Y") {
+                                cout << "Nothing added to cart.\n";
+                                break;
+                            }
+                            productName = suggestion;
+                        }
+                        cout << "Enter quantity: ";
+                        cin >> quantity;
+                        clearInputBuffer();
+                        customer.addToCart(catalog, productName, quantity);
                         break;
                     }
-                    case 3:
-                        customer.checkout(orders);
+                    case 5:
+                        customer.checkout(catalog, orders, durableOrders, &analytics);
                         break;
-                    case 4:
+                    case 6:
                         customerLoggedIn = false;
                         cout << "Customer logged out.\n";
                         break;
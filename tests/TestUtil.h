@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal checks for the test programs in tests/: a failed CHECK prints
+// its location and fails the program, whatever NDEBUG says.
+
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                     \
+    do {                                                                                     \
+        if (!(condition)) {                                                                  \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++testFailures();                                                                \
+        }                                                                                    \
+    } while (0)
+
+// Exit status for main(): non-zero if any CHECK failed.
+inline int testResult() {
+    if (testFailures() > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", testFailures());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
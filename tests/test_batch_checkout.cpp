@@ -0,0 +1,40 @@
+// BatchCheckout merges repeat lines for one product; a cart whose repeats
+// add up to more units than the stock type holds is a bad line, not a
+// wrapped-around small order.
+
+#include "BatchCheckout.h"
+#include "Catalog.h"
+#include "TestUtil.h"
+
+#include <string>
+#include <vector>
+
+int main() {
+    Catalog catalog;
+    catalog.insert(Product("Laptop", Money::fromCents(99999), 10));
+    catalog.insert(Product("Mouse", Money::fromCents(1999), 50));
+
+    std::string batch = std::string(BatchCheckout::HEADER) + "\n" +
+                        "alice,Mouse,2147483647,Mouse,2147483647,Mouse,4\n"  // 2^32 + 2 wraps to 2
+                        "bob,Mouse,2,Laptop,1,Mouse,3\n";
+    BatchCheckout checkout(2);
+    BatchCheckout::Result result;
+    std::vector<Order> orders;
+    checkout.process(catalog, batch, orders, result);
+
+    CHECK(result.badLines == 1);
+    CHECK(result.carts == 1);
+    CHECK(result.placed == 1);
+    CHECK(orders.size() == 1);
+    if (orders.size() == 1) {
+        CHECK(orders[0].getCustomerName() == "bob");
+        const LineItems& items = orders[0].getItems();
+        CHECK(items.size() == 2);
+        if (items.size() == 2) {
+            CHECK(items[0].productId == catalog.find("Mouse")->getId());
+            CHECK(items[0].quantity == 5);
+        }
+    }
+    CHECK(catalog.find("Mouse")->getStock() == 45);
+    return testResult();
+}
@@ -0,0 +1,41 @@
+// Customer::addToCart keeps every cart line within the stock type's range:
+// adds that would push a line past INT32_MAX units are refused instead of
+// wrapping to a small quantity. A checkout short of stock keeps the cart.
+
+#include "Catalog.h"
+#include "TestUtil.h"
+#include "Users.h"
+
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+int main() {
+    Catalog catalog;
+    catalog.insert(Product("Mouse", Money::fromCents(1999), 50));
+
+    std::ostringstream out;
+    Customer customer("alice", "pw");
+    customer.setOutput(out);
+    CHECK(!customer.addToCart(catalog, "Mouse", UINT32_MAX));
+    CHECK(customer.addToCart(catalog, "Mouse", INT32_MAX - 1));
+    CHECK(customer.addToCart(catalog, "Mouse", 1));
+    CHECK(!customer.addToCart(catalog, "Mouse", 1));
+    CHECK(!customer.addToCart(catalog, "Mouse", 0x80000001u));  // would wrap the line to 0
+
+    // The line still asks for INT32_MAX units, which the stock cannot cover.
+    std::vector<Order> orders;
+    customer.checkout(catalog, orders);
+    CHECK(orders.empty());
+    CHECK(catalog.find("Mouse")->getStock() == 50);
+
+    // Once stock arrives the same cart checks out, quantity intact.
+    catalog.insertOrAssign(Product("Mouse", Money::fromCents(1999), INT32_MAX));
+    customer.checkout(catalog, orders);
+    CHECK(orders.size() == 1);
+    if (orders.size() == 1) {
+        CHECK(orders[0].getItems().size() == 1 && orders[0].getItems()[0].quantity == uint32_t(INT32_MAX));
+    }
+    CHECK(catalog.find("Mouse")->getStock() == 0);
+    return testResult();
+}
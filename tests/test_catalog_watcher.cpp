@@ -0,0 +1,83 @@
+// A CatalogWatcher reload keeps the stock sessions reserved since the last
+// one: rewriting products.csv (unchanged, or with another row changed)
+// must not make sold units sellable again.
+
+#include "CatalogWatcher.h"
+#include "ShardedCatalog.h"
+#include "TestUtil.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+// Replaces the file by rename, as feed tools do. Every version gets its own
+// mtime, since rewrites can land within the filesystem's timestamp
+// granularity and CsvSync skips a file whose size and mtime are unchanged.
+static void writeFeed(const std::string& filename, int mouseStock) {
+    std::string temp = filename + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file << "Product Name,Price,Stock\n";
+        file << "Laptop,999.99,10\n";
+        file << "Mouse,19.99," << mouseStock << "\n";
+    }
+    static time_t version = 1000000;
+    timespec times[2] = {{++version, 0}, {version, 0}};
+    utimensat(AT_FDCWD, temp.c_str(), times, 0);
+    std::rename(temp.c_str(), filename.c_str());
+}
+
+// Waits up to 5 s for the watcher to have handled `events` change events
+// (reloads plus unchanged contents) since it started.
+static bool waitForEvents(const CatalogWatcher& watcher, uint64_t events) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        CatalogWatcher::Metrics metrics = watcher.metrics();
+        if (metrics.reloads + metrics.unchanged >= events) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+int main() {
+    const std::string filename = "test_watch_products.csv";
+    writeFeed(filename, 50);
+
+    ShardedCatalog catalog;
+    std::ostringstream log;
+    CatalogWatcher watcher(catalog, filename, log);
+    CHECK(watcher.start());
+    CHECK(watcher.metrics().reloads == 1);
+
+    const CatalogItem* laptop = catalog.read().find("Laptop");
+    CHECK(laptop != nullptr);
+    if (laptop) {
+        uint32_t id = laptop->getId();
+        LineItems items;
+        items.push_back(LineItem{id, 4, Money()});
+        CHECK(catalog.read().reserveStock(items) == -1);
+
+        // Touch the file with a different row changed.
+        writeFeed(filename, 60);
+        CHECK(waitForEvents(watcher, 2));
+        CHECK(catalog.read().findById(id)->getStock() == 6);
+        CHECK(catalog.read().find("Mouse")->getStock() == 60);
+
+        // Rewrite it with the same contents.
+        writeFeed(filename, 60);
+        CHECK(waitForEvents(watcher, 3));
+        CHECK(catalog.read().findById(id)->getStock() == 6);
+    }
+
+    watcher.stop();
+    std::remove(filename.c_str());
+    return testResult();
+}
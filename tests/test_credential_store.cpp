@@ -0,0 +1,51 @@
+// CredentialStore only lets an account log in once its registration is on
+// disk: a claim whose append fails is never visible to verify(), and
+// load() creates a missing accounts file.
+
+#include "CredentialStore.h"
+#include "TestUtil.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+int main() {
+    const std::string filename = "test_accounts.txt";
+    std::remove(filename.c_str());
+
+    // Never loaded, so the log is closed and every append fails; a reader
+    // polling meanwhile must never see the rolled-back account.
+    CredentialStore unopened(filename);
+    std::atomic<bool> done{false};
+    std::atomic<bool> seen{false};
+    std::thread reader([&] {
+        while (!done.load()) {
+            seen = seen || unopened.verify("bob", "pw");
+        }
+    });
+    for (int i = 0; i < 1000; ++i) {
+        CHECK(unopened.registerAccount("bob", "pw") == RegisterResult::StorageError);
+    }
+    done = true;
+    reader.join();
+    CHECK(!seen.load());
+    CHECK(!unopened.verify("bob", "pw"));
+
+    CredentialStore store(filename);
+    CHECK(store.load());
+    CHECK(::access(filename.c_str(), F_OK) == 0);
+    CHECK(store.registerAccount("alice", "secret") == RegisterResult::Registered);
+    CHECK(store.verify("alice", "secret"));
+    CHECK(store.contains("alice"));
+    CHECK(store.registerAccount("alice", "other") == RegisterResult::UsernameTaken);
+
+    CredentialStore reloaded(filename);
+    CHECK(reloaded.load());
+    CHECK(reloaded.verify("alice", "secret"));
+
+    std::remove(filename.c_str());
+    return testResult();
+}
@@ -0,0 +1,81 @@
+// OrderAnalytics totals rebuilt from a replayed order log keep their
+// per-product units and revenue, and rankings stay correct when a count
+// goes down.
+
+#include "Catalog.h"
+#include "OrderAnalytics.h"
+#include "OrderLog.h"
+#include "TestUtil.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static void testRestoreAfterReplay() {
+    const std::string filename = "test_analytics_orders.log";
+    std::remove(filename.c_str());
+
+    Catalog catalog;
+    catalog.insert(Product("Laptop", Money::fromCents(99999), 10));
+    catalog.insert(Product("Mouse", Money::fromCents(1999), 50));
+    {
+        std::vector<Order> replayed;
+        OrderLog::ReplayStats stats;
+        OrderLog log(filename);
+        CHECK(log.open(catalog, replayed, stats));
+        const Product* laptop = catalog.find("Laptop");
+        const Product* mouse = catalog.find("Mouse");
+        LineItems first;
+        first.push_back(LineItem{mouse->getId(), 4, mouse->getPrice()});
+        CHECK(log.append(Order("alice", std::move(first)), catalog));
+        LineItems second;
+        second.push_back(LineItem{laptop->getId(), 1, laptop->getPrice()});
+        second.push_back(LineItem{mouse->getId(), 2, mouse->getPrice()});
+        CHECK(log.append(Order("bob", std::move(second)), catalog));
+    }
+
+    std::vector<Order> orders;
+    OrderLog::ReplayStats stats;
+    OrderLog log(filename);
+    CHECK(log.open(catalog, orders, stats));
+    OrderAnalytics analytics;
+    for (const Order& order : orders) {
+        analytics.restore(order);
+    }
+
+    uint32_t mouseId = catalog.find("Mouse")->getId();
+    uint32_t laptopId = catalog.find("Laptop")->getId();
+    CHECK(analytics.orderCount() == 2);
+    CHECK(analytics.productTotals(mouseId).units == 6);
+    CHECK(analytics.productTotals(mouseId).revenue == Money::fromCents(6 * 1999));
+    CHECK(analytics.productTotals(laptopId).units == 1);
+    auto byUnits = analytics.topProductsByUnits(1);
+    CHECK(byUnits.size() == 1 && byUnits[0].key == mouseId);
+    auto byRevenue = analytics.topProductsByRevenue(1);
+    CHECK(byRevenue.size() == 1 && byRevenue[0].key == laptopId);
+
+    std::remove(filename.c_str());
+}
+
+static void testTopKCountDecrease() {
+    TopK<uint32_t> top(3);
+    top.offer(1, 10);
+    top.offer(2, 20);
+    top.offer(3, 30);
+    top.offer(3, 5);  // a refund-like negative line lowers a tracked count
+    top.offer(4, 8);  // evicts the new minimum, key 3
+
+    auto ranked = top.top(3);
+    CHECK(ranked.size() == 3);
+    if (ranked.size() == 3) {
+        CHECK(ranked[0].key == 2 && ranked[0].count == 20);
+        CHECK(ranked[1].key == 1 && ranked[1].count == 10);
+        CHECK(ranked[2].key == 4 && ranked[2].count == 8);
+    }
+}
+
+int main() {
+    testRestoreAfterReplay();
+    testTopKCountDecrease();
+    return testResult();
+}
@@ -0,0 +1,72 @@
+// Orders written to an OrderLog come back after a restart with their
+// products resolved against the catalog loaded at startup, whose ids need
+// not match the ones the orders were placed with.
+
+#include "Catalog.h"
+#include "OrderLog.h"
+#include "TestUtil.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+int main() {
+    const std::string filename = "test_orders.log";
+    std::remove(filename.c_str());
+
+    {
+        Catalog catalog;
+        catalog.insert(Product("Laptop", Money::fromCents(99999), 10));
+        catalog.insert(Product("Mouse", Money::fromCents(1999), 50));
+        const Product* laptop = catalog.find("Laptop");
+        const Product* mouse = catalog.find("Mouse");
+
+        std::vector<Order> replayed;
+        OrderLog::ReplayStats stats;
+        OrderLog log(filename);
+        CHECK(log.open(catalog, replayed, stats));
+        CHECK(replayed.empty());
+
+        LineItems items;
+        items.push_back(LineItem{laptop->getId(), 1, laptop->getPrice()});
+        items.push_back(LineItem{mouse->getId(), 3, mouse->getPrice()});
+        CHECK(log.append(Order("alice", std::move(items)), catalog));
+    }
+
+    // A restarted process loads the products in a different order, so the
+    // ids differ from the ones recorded above.
+    Catalog catalog;
+    catalog.insert(Product("Keyboard", Money::fromCents(4999), 5));
+    catalog.insert(Product("Mouse", Money::fromCents(1999), 47));
+    catalog.insert(Product("Laptop", Money::fromCents(99999), 9));
+
+    std::vector<Order> orders;
+    OrderLog::ReplayStats stats;
+    OrderLog log(filename);
+    CHECK(log.open(catalog, orders, stats));
+    CHECK(stats.ordersReplayed == 1);
+    CHECK(stats.unknownProducts == 0);
+    CHECK(orders.size() == 1);
+    if (orders.size() == 1) {
+        const LineItems& items = orders[0].getItems();
+        CHECK(orders[0].getCustomerName() == "alice");
+        CHECK(items.size() == 2);
+        if (items.size() == 2) {
+            CHECK(items[0].productId == catalog.find("Laptop")->getId());
+            CHECK(items[0].quantity == 1);
+            CHECK(items[1].productId == catalog.find("Mouse")->getId());
+            CHECK(items[1].quantity == 3);
+        }
+        CHECK(orders[0].total() == Money::fromCents(99999 + 3 * 1999));
+    }
+
+    // Against an empty catalog the same order replays with unknown products.
+    Catalog empty;
+    std::vector<Order> unresolved;
+    OrderLog reopened(filename);
+    CHECK(reopened.open(empty, unresolved, stats));
+    CHECK(stats.unknownProducts == 2);
+
+    std::remove(filename.c_str());
+    return testResult();
+}
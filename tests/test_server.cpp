@@ -0,0 +1,154 @@
+// Server::start() fails cleanly for a numeric endpoint that is not a valid
+// TCP port, instead of throwing or binding a truncated port; and admin
+// sessions share one CsvSync, so a changed products file is applied once
+// however many sessions UPLOAD it.
+
+#include "CredentialStore.h"
+#include "Server.h"
+#include "ShardedCatalog.h"
+#include "TestUtil.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Minimal blocking client for the line protocol.
+class Client {
+    int fd = -1;
+
+public:
+    explicit Client(const std::string& path) {
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ~Client() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    bool connected() const { return fd >= 0; }
+
+    // Sends one request; returns the response body, prefixed "ERR " on an
+    // error response.
+    std::string request(const std::string& line) {
+        std::string message = line + "\n";
+        if (::send(fd, message.data(), message.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(message.size())) {
+            return "ERR send";
+        }
+        std::string header;
+        char c;
+        while (::recv(fd, &c, 1, 0) == 1 && c != '\n') {
+            header += c;
+        }
+        size_t space = header.find(' ');
+        size_t length = space == std::string::npos ? 0 : std::stoul(header.substr(space + 1));
+        std::string body(length, '\0');
+        for (size_t got = 0; got < length;) {
+            ssize_t n = ::recv(fd, body.data() + got, length - got, 0);
+            if (n <= 0) {
+                break;
+            }
+            got += static_cast<size_t>(n);
+        }
+        return header.rfind("OK", 0) == 0 ? body : "ERR " + body;
+    }
+};
+
+static void writeFeed(const std::string& filename, int stock) {
+    {
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        file << "Product Name,Price,Stock\n";
+        file << "Laptop,999.99," << stock << "\n";
+    }
+    static time_t version = 1000000;
+    timespec times[2] = {{++version, 0}, {version, 0}};
+    utimensat(AT_FDCWD, filename.c_str(), times, 0);
+}
+
+static void testInvalidPorts() {
+    uint16_t port = 0;
+    CHECK(Server::parsePort("8080", port) && port == 8080);
+    CHECK(Server::parsePort("65535", port) && port == 65535);
+    CHECK(!Server::parsePort("0", port));
+    CHECK(!Server::parsePort("65536", port));
+    CHECK(!Server::parsePort("99999999999999999999", port));
+    CHECK(!Server::parsePort("", port));
+
+    ShardedCatalog catalog;
+    CredentialStore credentials("test_server_accounts.txt");
+    std::vector<Order> orders;
+    for (const char* endpoint : {"65536", "4294967297", "99999999999999999999"}) {
+        Server::Config config;
+        config.endpoint = endpoint;
+        Server server(config, catalog, credentials, orders);
+        CHECK(!server.start());
+    }
+}
+
+static void testSessionsShareProductSync() {
+    const std::string socketPath = "test_server.sock";
+    const std::string csvFile = "test_server_products.csv";
+    writeFeed(csvFile, 10);
+
+    ShardedCatalog catalog;
+    CredentialStore credentials("test_server_accounts.txt");
+    std::vector<Order> orders;
+    Server::Config config;
+    config.endpoint = socketPath;
+    config.productCSVFile = csvFile;
+    config.workers = 2;
+    Server server(config, catalog, credentials, orders);
+    CHECK(server.start());
+    std::thread loop([&] { server.run(); });
+
+    {
+        Client first(socketPath);
+        Client second(socketPath);
+        CHECK(first.connected() && second.connected());
+        CHECK(first.request("ADMIN admin,1234").rfind("ERR", 0) != 0);
+        CHECK(second.request("ADMIN admin,1234").rfind("ERR", 0) != 0);
+
+        first.request("UPLOAD");
+        second.request("UPLOAD");
+        const CatalogItem* laptop = catalog.read().find("Laptop");
+        CHECK(laptop && laptop->getStock() == 10);
+
+        // The feed restocks by 10: both sessions upload it, once applied.
+        writeFeed(csvFile, 20);
+        first.request("UPLOAD");
+        second.request("UPLOAD");
+        laptop = catalog.read().find("Laptop");
+        CHECK(laptop && laptop->getStock() == 20);
+
+        first.request("QUIT");
+        second.request("QUIT");
+    }
+
+    server.stop();
+    loop.join();
+    std::remove(csvFile.c_str());
+    std::remove(socketPath.c_str());
+}
+
+int main() {
+    testInvalidPorts();
+    testSessionsShareProductSync();
+    std::remove("test_server_accounts.txt");
+    return testResult();
+}
@@ -0,0 +1,48 @@
+// ShardedCatalog::publishWithIds keeps the ids a Catalog handed out, gaps
+// from erased products included, so orders replayed and analytics restored
+// against the Catalog still name the right products once the server serves
+// the sharded copy.
+
+#include "Catalog.h"
+#include "ShardedCatalog.h"
+#include "TestUtil.h"
+
+#include <string>
+#include <vector>
+
+int main() {
+    Catalog startup;
+    startup.insert(Product("Keyboard", Money::fromCents(4999), 5));
+    startup.insert(Product("Laptop", Money::fromCents(99999), 10));
+    startup.insert(Product("Mouse", Money::fromCents(1999), 50));
+    CHECK(startup.erase("Keyboard"));
+
+    ShardedCatalog catalog;
+    CHECK(catalog.publishWithIds(startup));
+    CHECK(catalog.size() == 2);
+    ShardedCatalog::Reader view = catalog.read();
+    for (const Product& product : startup) {
+        const CatalogItem* item = view.find(product.getName());
+        CHECK(item != nullptr);
+        if (item) {
+            CHECK(item->getId() == product.getId());
+            CHECK(item->getPrice() == product.getPrice());
+            CHECK(item->getStock() == product.getStock());
+            CHECK(view.findById(product.getId()) == item);
+        }
+    }
+    CHECK(view.find("Keyboard") == nullptr);
+
+    // Reservations go through the same ids.
+    LineItems items;
+    items.push_back(LineItem{startup.find("Mouse")->getId(), 3, Money()});
+    CHECK(view.reserveStock(items) == -1);
+    CHECK(view.find("Mouse")->getStock() == 47);
+
+    // New products continue after the Catalog's ids; a second wholesale
+    // publish is refused.
+    catalog.insertOrAssign(Product("Monitor", Money::fromCents(19999), 4));
+    CHECK(catalog.read().find("Monitor")->getId() == startup.idLimit());
+    CHECK(!catalog.publishWithIds(startup));
+    return testResult();
+}